@@ -41,6 +41,10 @@ int main() {
     // - Para hashing simples, pode usar soma dos valores ASCII do nome ou primeira letra.
     // - Em caso de colisão, use lista encadeada para tratar.
     // - Modularize com funções como inicializarHash(), buscarSuspeito(), listarAssociacoes().
+    //
+    // Referência pronta (não copie antes de tentar): desafio_mestre.c, com o motor em mestre/;
+    // o suspeito mais provável está em suspeitoMaisProvavel() e suspeitosMaisProvaveis(),
+    // em mestre/sessao.c.
 
     return 0;
 }
@@ -0,0 +1,43 @@
+/* associacoes_fixas.h - gerado por: desafio_mestre --gerar-hash mapas/mansao_enigma.txt
+   Não editar. Hash perfeito mínimo das associações pista -> suspeito: o grupo
+   (bits altos do hashChave) dá o deslocamento e o deslocamento dá o slot.
+   As implicações do processo seguem na ordem do arquivo. */
+
+#ifndef ASSOCIACOES_FIXAS_H
+#define ASSOCIACOES_FIXAS_H
+
+#define TOTAL_ASSOCIACOES_FIXAS 8
+#define GRUPOS_ASSOCIACOES_FIXAS 3
+
+static const uint32_t DESLOCAMENTOS_FIXOS[GRUPOS_ASSOCIACOES_FIXAS] = {
+    0, 0, 26
+};
+
+static const AssociacaoFixa ASSOCIACOES_FIXAS[TOTAL_ASSOCIACOES_FIXAS] = {
+    { 0xc48072ebc40c3cabULL, "Copo quebrado", "Sra. Marinho" },
+    { 0x87fe77de249961b9ULL, "Diário antigo", "Sr. Rocha" },
+    { 0xf7c18dd37687a413ULL, "Lenço rasgado", "Sra. Marinho" },
+    { 0x39e582473743204eULL, "Marca de tinta vermelha", "Pintor" },
+    { 0x9876d6d783d699a5ULL, "Pegada de lama", "Sr. Verdes" },
+    { 0xdf4912442bc7f961ULL, "Luvas sujas", "Sr. Rocha" },
+    { 0x942c064bab940af1ULL, "Chave enferrujada", "Sr. Verdes" },
+    { 0x7bd980e09a6a2532ULL, "Pneu com marca estranha", "Motorista" },
+};
+
+#define TOTAL_IMPLICACOES_FIXAS 11
+
+static const ImplicacaoFixa IMPLICACOES_FIXAS[TOTAL_IMPLICACOES_FIXAS] = {
+    { "Pegada de lama", "Sr. Verdes", 2 },
+    { "Pegada de lama", "Motorista", 1 },
+    { "Lenço rasgado", "Sra. Marinho", 3 },
+    { "Lenço rasgado", "Sr. Rocha", 1 },
+    { "Copo quebrado", "Sr. Verdes", 2 },
+    { "Diário antigo", "Sr. Rocha", 4 },
+    { "Diário antigo", "Sra. Marinho", 2 },
+    { "Chave enferrujada", "Motorista", 2 },
+    { "Luvas sujas", "Sr. Rocha", 2 },
+    { "Luvas sujas", "Pintor", 3 },
+    { "Marca de tinta vermelha", "Sr. Rocha", 1 },
+};
+
+#endif
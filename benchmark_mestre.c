@@ -0,0 +1,1016 @@
+/*
+  Detective Quest - Benchmark das estruturas do Capítulo Final
+  - inserirPista: entradas aleatórias, ordenadas e com muitas repetições
+  - montarPistas (ordenação paralela + ligação balanceada) nas mesmas entradas
+  - estatísticas de ordem: k-ésima pista, posição e página no meio da árvore pelos tamanhos
+    das subárvores x o iterador pulando até lá; falha se divergirem
+  - hash_djb2 x hashTexto (kernels escalar/SSE2/AVX2), textos curtos e longos
+  - encontrarSuspeitoId: acerto/erro com fatores de carga variados, sem e com filtro de Bloom,
+    e em potências de 2 em volta de FILTRO_ENTRADAS_MINIMAS (de onde o limiar saiu)
+  - associações da mansão fixa: hash perfeito gerado x tabela dinâmica
+  - verificarSuspeitoFinal (percurso da árvore) x verificarAcusacao (contadores)
+  - processo do caso: todos os suspeitos pontuados pelos bitsets (kernels escalar/POPCNT/AVX2)
+    x um percurso da árvore por suspeito; falha se algum kernel divergir da soma direta
+  - ranking de suspeitos: atualização do heap por evidência e consulta top-k
+  - histórico: coleta na árvore mutável x persistente, marcar/coletar/desfazer, bifurcação
+    x cópia integral da árvore; falha se desfazer ou o ramo alterarem a sessão de origem
+  - sessões roteirizadas completas numa mansão gerada
+  - rotas: montagem do índice, ancestral comum e pista nova mais próxima
+  - conversão do mapa em texto com associações redeclaradas, carregado de volta; falha se o
+    conjunto de associações carregado não for o declarado (vale a última de cada pista)
+  - tabela concorrente sob estresse: leitores em todos os núcleos contra um escritor que
+    insere (a tabela cresce) e substitui; o programa falha se um leitor vir um par inválido
+  Para cada tamanho (10, 100, ... até --max) reporta ns/op, alocações e o pico de RSS que
+  o caso acrescentou (cada caso roda num processo filho). Os testes de comportamento, sem
+  medição de tempo, ficam em testes_mestre.c (make test).
+
+  Compilação: make benchmark_mestre   (ou gcc -O2 -pthread benchmark_mestre.c -o benchmark_mestre:
+              as fontes do motor são incluídas aqui)
+  Uso:        ./benchmark_mestre [--max 10000000]   (padrão: 1000000)
+*/
+
+#define _POSIX_C_SOURCE 200809L   // o mesmo de mestre/comum.h, antes do primeiro cabeçalho
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* contagem de alocações: as chamadas do motor (os .c de mestre/) passam por aqui */
+static unsigned long totalAlocacoes = 0;
+
+static void* contarMalloc(size_t n) { totalAlocacoes++; return malloc(n); }
+static void* contarCalloc(size_t n, size_t m) { totalAlocacoes++; return calloc(n, m); }
+static void* contarRealloc(void *p, size_t n) { totalAlocacoes++; return realloc(p, n); }
+
+#define malloc(n) contarMalloc(n)
+#define calloc(n, m) contarCalloc(n, m)
+#define realloc(p, n) contarRealloc(p, n)
+/* o motor entra como fontes (e não como objetos) para que as macros valham nele e para
+   que os casos alcancem os auxiliares static de cada módulo */
+#include "mestre/memoria.c"
+#include "mestre/hash.c"
+#include "mestre/tabela.c"
+#include "mestre/textos.c"
+#include "mestre/associacoes.c"
+#include "mestre/concorrente.c"
+#include "mestre/pistas.c"
+#include "mestre/trie.c"
+#include "mestre/processo.c"
+#include "mestre/sessao.c"
+#include "mestre/mansao.c"
+#include "mestre/paginada.c"
+#include "mestre/rotas.c"
+#include "mestre/exploracao.c"
+#include "mestre/lote.c"
+#include "mestre/mapa.c"
+#include "mestre/instantaneo.c"
+#include "mestre/estatisticas.c"
+#undef malloc
+#undef calloc
+#undef realloc
+
+#define OPS_MINIMAS 1000000   // cada medição repete até somar pelo menos isso de operações
+#define TOTAL_SUSPEITOS 100
+#define LARGURA_CASO 46       // coluna do nome do caso, em caracteres na tela
+
+/* ------------------ Utilitários de medição ------------------ */
+
+static double agoraNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static long picoRssKb(void) {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+/* o pico de RSS de um processo só cresce, então cada caso roda num filho: lá o pico começa
+   no RSS herdado do pai (a linha de base) e a coluna mostra só o que o caso acrescentou */
+static long rssBaseKb = 0;
+
+#define ISOLADO(caso) do {                                                              \
+        fflush(stdout);                                                                 \
+        pid_t filho = fork();                                                           \
+        if (filho < 0) { perror("fork"); exit(EXIT_FAILURE); }                          \
+        if (filho == 0) { rssBaseKb = picoRssKb(); caso; fflush(stdout); _exit(0); }    \
+        int status;                                                                     \
+        if (waitpid(filho, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) \
+            exit(EXIT_FAILURE);                                                         \
+    } while (0)
+
+/* xorshift64: gerador determinístico para as entradas */
+static uint64_t estadoAleatorio = 0x9E3779B97F4A7C15ULL;
+static uint64_t aleatorio(void) {
+    estadoAleatorio ^= estadoAleatorio << 13;
+    estadoAleatorio ^= estadoAleatorio >> 7;
+    estadoAleatorio ^= estadoAleatorio << 17;
+    return estadoAleatorio;
+}
+
+/* imprimirCaso: o nome alinhado pela largura na tela; "%-*s" conta bytes, e cada letra
+   acentuada ocupa dois em UTF-8 */
+static void imprimirCaso(const char *caso) {
+    int largura = 0;
+    for (const unsigned char *c = (const unsigned char*) caso; *c; c++)
+        largura += (*c & 0xC0) != 0x80;   // bytes de continuação não ocupam coluna
+    printf("%s%*s", caso, largura < LARGURA_CASO ? LARGURA_CASO - largura : 0, "");
+}
+
+/* resultados: uma linha por medição */
+static void relatar(const char *caso, size_t n, double ns, unsigned long ops, unsigned long allocs) {
+    imprimirCaso(caso);
+    printf(" %9zu %12.1f %12.3f %10ld\n", n, ns / (double) ops,
+           (double) allocs / (double) ops, picoRssKb() - rssBaseKb);
+}
+
+static unsigned long repeticoes(size_t n) {
+    return n >= OPS_MINIMAS ? 1 : (unsigned long) (OPS_MINIMAS / n);
+}
+
+/* idsPistas: n pistas internadas ("Pista 00000042"), na ordem pedida */
+static IdTexto* idsPistas(size_t n, const char *ordem) {
+    IdTexto *ids = (IdTexto*) malloc(n * sizeof(IdTexto));
+    int repetidas = strcmp(ordem, "repetidas") == 0;
+    size_t distintas = n / 100 ? n / 100 : 1;   // repetidas: ~100 ocorrências de cada pista
+    char texto[32];
+    for (size_t i = 0; i < n; i++) {
+        size_t k = repetidas ? (size_t) (aleatorio() % distintas) : i;   // aleatórias: embaralhadas abaixo
+        snprintf(texto, sizeof(texto), "Pista %08zu", k);
+        ids[i] = internar(texto);
+    }
+    if (strcmp(ordem, "aleatórias") == 0) {
+        for (size_t i = n - 1; i > 0; i--) {
+            size_t j = (size_t) (aleatorio() % (i + 1));
+            IdTexto t = ids[i]; ids[i] = ids[j]; ids[j] = t;
+        }
+    }
+    return ids;
+}
+
+/* ------------------ Casos ------------------ */
+
+static void medirInsercao(size_t n, const char *ordem) {
+    IdTexto *ids = idsPistas(n, ordem);
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    unsigned long reps = repeticoes(n), a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        PistaNode *raiz = NULL;
+        for (size_t i = 0; i < n; i++) raiz = inserirPista(raiz, ids[i]);
+        arenaResetar(&arena);
+    }
+    double t = agoraNs() - t0;
+    char caso[64];
+    snprintf(caso, sizeof(caso), "inserirPista (%s)", ordem);
+    relatar(caso, n, t, reps * n, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+
+    // sem arena: uma alocação por nó, liberadas pelo fallback liberarPistas
+    PistaNode *raiz = NULL;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (size_t i = 0; i < n; i++) raiz = inserirPista(raiz, ids[i]);
+    t = agoraNs() - t0;
+    snprintf(caso, sizeof(caso), "inserirPista (%s, malloc)", ordem);
+    relatar(caso, n, t, n, totalAlocacoes - a0);
+    liberarPistas(raiz);
+    free(ids);
+}
+
+/* medirCargaEmLote: o mesmo lote de medirInsercao entregue de uma vez a montarPistas */
+static void medirCargaEmLote(size_t n, const char *ordem) {
+    IdTexto *ids = idsPistas(n, ordem);
+    PistaContada *lote = (PistaContada*) malloc(n * sizeof(PistaContada));
+    for (size_t i = 0; i < n; i++) {
+        lote[i].pista = ids[i];
+        lote[i].ocorrencias = 1;
+    }
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    unsigned long reps = repeticoes(n), a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        montarPistas(lote, n);
+        arenaResetar(&arena);
+    }
+    char caso[64];
+    snprintf(caso, sizeof(caso), "montarPistas (%s)", ordem);
+    relatar(caso, n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    free(lote);
+    free(ids);
+}
+
+/* contarVisitadas: visitante que só conta (e confere a ordem das páginas) */
+static int contarVisitadas(const PistaNode *no, void *contexto) {
+    const PistaNode **anterior = (const PistaNode**) contexto;
+    if (*anterior && strcmp(textoDe((*anterior)->pista), textoDe(no->pista)) >= 0) {
+        fprintf(stderr, "visitarPagina fora de ordem em \"%s\"\n", textoDe(no->pista));
+        exit(EXIT_FAILURE);
+    }
+    *anterior = no;
+    return 0;
+}
+
+/* medirOrdem: árvore com as pistas 0..n-1 ("Pista %08zu", logo a k-ésima é a de número k) e
+   1 a 4 ocorrências cada. Consultas em posições aleatórias; a página é a de PISTAS_POR_PAGINA
+   pistas que começa no meio. O programa falha se alguma resposta divergir da esperada. */
+static void medirOrdem(size_t n) {
+    IdTexto *ids = idsPistas(n, "aleatórias");
+    PistaContada *lote = (PistaContada*) malloc(n * sizeof(PistaContada));
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        lote[i].pista = ids[i];
+        lote[i].ocorrencias = 1 + (int) (aleatorio() % 4);
+        total += (uint64_t) lote[i].ocorrencias;
+    }
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    PistaNode *raiz = montarPistas(lote, n);
+    char texto[32];
+    uint64_t ocorrencias;
+    if (raiz->tamanho != n || raiz->ocorrenciasSubarvore != total ||
+        contarIntervaloPistas(raiz, NULL, NULL, &ocorrencias) != n || ocorrencias != total) {
+        fprintf(stderr, "tamanho/ocorrências da raiz divergentes (n = %zu)\n", n);
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long reps = repeticoes(n) / 8 + 1, a0 = totalAlocacoes;
+    volatile size_t acumulado = 0;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        size_t k = (size_t) (aleatorio() % n);
+        const PistaNode *no = selecionarPista(raiz, k);
+        snprintf(texto, sizeof(texto), "Pista %08zu", k);
+        if (!no || strcmp(textoDe(no->pista), texto) != 0) {
+            fprintf(stderr, "selecionarPista(%zu) divergente\n", k);
+            exit(EXIT_FAILURE);
+        }
+        acumulado += (size_t) no->ocorrencias;
+    }
+    relatar("selecionarPista (k aleatório)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        size_t k = (size_t) (aleatorio() % n);
+        snprintf(texto, sizeof(texto), "Pista %08zu", k);
+        size_t posicao = posicaoDaPista(raiz, texto, NULL);
+        if (posicao != k) {
+            fprintf(stderr, "posicaoDaPista(\"%s\") = %zu\n", texto, posicao);
+            exit(EXIT_FAILURE);
+        }
+        acumulado += posicao;
+    }
+    relatar("posicaoDaPista (texto aleatório)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    // página no meio: o iterador passa por todas as anteriores; visitarPagina desce direto
+    size_t inicio = n / 2, limite = PISTAS_POR_PAGINA;
+    reps = repeticoes(n) / (n / 2 + limite) + 1;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        IteradorPistas it;
+        iniciarIterador(&it, raiz);
+        size_t i = 0;
+        for (const PistaNode *no; i < inicio + limite && (no = proximaPista(&it)) != NULL; i++)
+            if (i >= inicio) acumulado += (size_t) no->ocorrencias;
+    }
+    relatar("página no meio (iterador)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    reps = repeticoes(n) / limite + 1;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        const PistaNode *anterior = NULL;
+        size_t visitadas = visitarPagina(raiz, inicio, limite, contarVisitadas, &anterior);
+        snprintf(texto, sizeof(texto), "Pista %08zu", inicio + visitadas - 1);
+        if (visitadas != (n - inicio < limite ? n - inicio : limite) || strcmp(textoDe(anterior->pista), texto) != 0) {
+            fprintf(stderr, "visitarPagina(%zu, %zu) divergente\n", inicio, limite);
+            exit(EXIT_FAILURE);
+        }
+    }
+    relatar("visitarPagina (no meio)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    free(lote);
+    free(ids);
+}
+
+/* medirHashTextos: djb2 x hashTexto em cada kernel, com textos curtos e de 128 bytes */
+static void medirHashTextos(size_t n) {
+    IdTexto *ids = idsPistas(n, "ordenadas");
+    const char **curtos = (const char**) malloc(n * sizeof(char*));
+    size_t *tamCurtos = (size_t*) malloc(n * sizeof(size_t));
+    char *longos = (char*) malloc(n * 129);
+    for (size_t i = 0; i < n; i++) {
+        curtos[i] = textoDe(ids[i]);
+        tamCurtos[i] = strlen(curtos[i]);
+        // pista alinhada à direita num texto de 128 bytes
+        memset(longos + i * 129, 'x', 128 - tamCurtos[i]);
+        memcpy(longos + i * 129 + 128 - tamCurtos[i], curtos[i], tamCurtos[i] + 1);
+    }
+    struct { const char *nome; KernelHash kernel; } kernels[] = {
+        { "escalar", faixasEscalar },
+#if defined(__SSE2__)
+        { "sse2", faixasSse2 },
+#endif
+#ifdef HASH_COM_AVX2
+        { "avx2", faixasAvx2 },
+#endif
+    };
+    int totalKernels = (int) (sizeof(kernels) / sizeof(kernels[0]));
+#ifdef HASH_COM_AVX2
+    if (!__builtin_cpu_supports("avx2")) totalKernels--;
+#endif
+    unsigned long reps = repeticoes(n);
+    volatile unsigned long acumulado = 0;
+    char caso[64];
+    for (int longo = 0; longo < 2; longo++) {
+        const char *rotulo = longo ? "128 B" : "curto";
+        unsigned long a0 = totalAlocacoes;
+        double t0 = agoraNs();
+        for (unsigned long r = 0; r < reps; r++)
+            for (size_t i = 0; i < n; i++)
+                acumulado += hash_djb2(longo ? longos + i * 129 : curtos[i]);
+        snprintf(caso, sizeof(caso), "hash_djb2 (%s)", rotulo);
+        relatar(caso, n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+        for (int k = 0; k < totalKernels; k++) {
+            a0 = totalAlocacoes;
+            t0 = agoraNs();
+            for (unsigned long r = 0; r < reps; r++)
+                for (size_t i = 0; i < n; i++)
+                    acumulado += longo ? hashComKernel(longos + i * 129, 128, kernels[k].kernel)
+                                       : hashComKernel(curtos[i], tamCurtos[i], kernels[k].kernel);
+            snprintf(caso, sizeof(caso), "hashTexto %s (%s)", kernels[k].nome, rotulo);
+            relatar(caso, n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+        }
+    }
+    free(longos);
+    free(tamCurtos);
+    free(curtos);
+    free(ids);
+}
+
+/* medirBusca: capacidade fixa (potência de 2 >= n) preenchida até 'oitavos'/8;
+   as chaves de erro foram internadas mas nunca associadas */
+static void medirBusca(size_t n, int oitavos) {
+    size_t cap = HASH_CAPACIDADE_INICIAL;
+    while (cap < n) cap *= 2;
+    size_t m = cap * (size_t) oitavos / 8;
+    IdTexto *ids = idsPistas(2 * m, "aleatórias");
+    TabelaHash hash;
+    hash.arena = NULL;
+    hash.fixas = 0;
+    hash.concorrente = NULL;
+    hash.filtro.palavras = NULL;
+    alocarSlots(&hash, cap);
+    char suspeito[32];
+    for (size_t i = 0; i < m; i++) {
+        snprintf(suspeito, sizeof(suspeito), "Suspeito %zu", i % TOTAL_SUSPEITOS);
+        inserirNaHashId(&hash, ids[i], internar(suspeito));
+    }
+    unsigned long reps = repeticoes(m);
+    volatile IdTexto acumulado = 0;
+    char caso[64];
+    for (int filtro = 0; filtro < 2; filtro++) {
+        if (filtro) ativarFiltro(&hash);
+        for (int erro = 0; erro < 2; erro++) {
+            unsigned long a0 = totalAlocacoes;
+            double t0 = agoraNs();
+            for (unsigned long r = 0; r < reps; r++)
+                for (size_t i = 0; i < m; i++) acumulado += encontrarSuspeitoId(&hash, ids[erro * m + i]);
+            snprintf(caso, sizeof(caso), "encontrarSuspeito %s%s (carga %.3f)", erro ? "erro" : "acerto",
+                     filtro ? "+Bloom" : "", (double) hash.tamanho / (double) hash.capacidade);
+            relatar(caso, m, agoraNs() - t0, reps * m, totalAlocacoes - a0);
+        }
+    }
+    liberarHash(&hash);
+    free(ids);
+}
+
+static void medirAcusacao(size_t n) {
+    IdTexto *ids = idsPistas(n, "aleatórias");
+    TabelaHash hash;
+    inicializarHash(&hash);
+    char suspeito[32];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(suspeito, sizeof(suspeito), "Suspeito %zu", i % TOTAL_SUSPEITOS);
+        inserirNaHashId(&hash, ids[i], internar(suspeito));
+    }
+    Sessao sessao;
+    iniciarSessao(&sessao);
+    for (size_t i = 0; i < n; i++) coletarPista(&sessao, &hash, ids[i]);
+
+    // o percurso da árvore é O(n) por acusação: menos repetições
+    unsigned long reps = repeticoes(n) / 64 + 1, a0 = totalAlocacoes;
+    volatile int acumulado = 0;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++)
+        acumulado += verificarSuspeitoFinal(sessao.raizPistas, &hash, "Suspeito 7");
+    relatar("verificarSuspeitoFinal (árvore)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    reps = OPS_MINIMAS;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) acumulado += verificarAcusacao(&sessao, "Suspeito 7");
+    relatar("verificarAcusacao (contadores)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    liberarSessao(&sessao);
+    liberarHash(&hash);
+    free(ids);
+}
+
+/* medirPontuacao: n pistas, cada uma implicando 1 a 3 dos TOTAL_SUSPEITOS com pesos 1..15,
+   e uma sessão com metade delas. Todos os suspeitos pontuados de uma vez pelos bitsets, em
+   cada kernel, x um percurso da árvore por suspeito (verificarSuspeitoFinal, que só vê a
+   associação principal). O programa falha se um kernel divergir da soma direta dos pesos. */
+static void medirPontuacao(size_t n) {
+    IdTexto *ids = idsPistas(n, "aleatórias");
+    IdTexto suspeitos[TOTAL_SUSPEITOS];
+    uint64_t esperado[TOTAL_SUSPEITOS] = { 0 };
+    uint32_t esperadas[TOTAL_SUSPEITOS] = { 0 };
+    char nome[32];
+    for (int s = 0; s < TOTAL_SUSPEITOS; s++) {
+        snprintf(nome, sizeof(nome), "Suspeito %d", s);
+        suspeitos[s] = internar(nome);
+    }
+    Processo processo;
+    iniciarProcesso(&processo);
+    TabelaHash hash;
+    inicializarHash(&hash);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t primeiro = (uint32_t) (aleatorio() % TOTAL_SUSPEITOS), k = 1 + (uint32_t) (aleatorio() % 3);
+        for (uint32_t j = 0; j < k; j++) {
+            uint32_t s = (primeiro + 37 * j) % TOTAL_SUSPEITOS, peso = 1 + (uint32_t) (aleatorio() % 15);
+            registrarImplicacao(&processo, ids[i], suspeitos[s], peso);
+            if (i % 2) { esperado[s] += peso; esperadas[s]++; }
+        }
+        inserirNaHashId(&hash, ids[i], suspeitos[primeiro]);
+    }
+    compilarProcesso(&processo);
+    Sessao sessao;
+    iniciarSessao(&sessao);
+    sessao.processo = &processo;
+    for (size_t i = 1; i < n; i += 2) coletarPista(&sessao, &hash, ids[i]);
+
+    // referência: um percurso da árvore por suspeito
+    unsigned long reps = repeticoes(n) / (64 * TOTAL_SUSPEITOS) + 1, a0 = totalAlocacoes;
+    volatile uint64_t acumulado = 0;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++)
+        for (int s = 0; s < TOTAL_SUSPEITOS; s++)
+            acumulado += (uint64_t) contarPistasDoSuspeito(sessao.raizPistas, &hash, suspeitos[s]);
+    relatar("pontuar 100 suspeitos (árvore x100)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    struct { const char *nome; KernelPontuacao kernel; int suportado; } kernels[] = {
+        { "escalar", contarEscalar, 1 },
+#ifdef PONTUACAO_COM_X86
+        { "popcnt", contarPopcnt, __builtin_cpu_supports("popcnt") },
+        { "avx2", contarAvx2, __builtin_cpu_supports("avx2") },
+#endif
+    };
+    PontuacaoSuspeito *pts = (PontuacaoSuspeito*) malloc(processo.totalSuspeitos * sizeof(PontuacaoSuspeito));
+    char caso[64];
+    reps = repeticoes(n) / TOTAL_SUSPEITOS + 1;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!kernels[k].suportado) continue;
+        a0 = totalAlocacoes;
+        t0 = agoraNs();
+        for (unsigned long r = 0; r < reps; r++) {
+            pontuarComKernel(&processo, sessao.coletadas, pts, kernels[k].kernel);
+            acumulado += pts[0].peso;
+        }
+        snprintf(caso, sizeof(caso), "pontuarSuspeitos %s (100 suspeitos)", kernels[k].nome);
+        relatar(caso, n, agoraNs() - t0, reps, totalAlocacoes - a0);
+        for (uint32_t i = 0; i < processo.totalSuspeitos; i++) {
+            int s = 0;
+            while (suspeitos[s] != pts[i].suspeito) s++;
+            if (pts[i].peso != esperado[s] || pts[i].pistas != esperadas[s]) {
+                fprintf(stderr, "pontuação %s divergente: %s peso %llu/%llu pistas %u/%u\n", kernels[k].nome,
+                        textoDe(pts[i].suspeito), (unsigned long long) pts[i].peso,
+                        (unsigned long long) esperado[s], pts[i].pistas, esperadas[s]);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    free(pts);
+    liberarSessao(&sessao);
+    liberarProcesso(&processo);
+    liberarHash(&hash);
+    free(ids);
+}
+
+/* conferirSessao: o estado da sessão ainda é o de referência (n pistas, uma ocorrência cada,
+   evidências por suspeito e líder do ranking) */
+static void conferirSessao(const Sessao *sessao, const char *depois, size_t n,
+                           const IdTexto *suspeitos, const int *evidencias, IdTexto lider) {
+    int ok = sessao->raizPistas && sessao->raizPistas->tamanho == n &&
+             sessao->raizPistas->ocorrenciasSubarvore == n && suspeitoMaisProvavel(sessao) == lider;
+    for (int s = 0; ok && s < TOTAL_SUSPEITOS; s++) ok = evidenciasDe(sessao, suspeitos[s]) == evidencias[s];
+    IdTexto topo[RANKING_EXIBIDO];
+    ok = ok && suspeitosMaisProvaveis(sessao, topo, RANKING_EXIBIDO) == RANKING_EXIBIDO && topo[0] == lider;
+    if (!ok) {
+        fprintf(stderr, "sessão divergente depois de %s (n = %zu)\n", depois, n);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* medirHistorico: n pistas distintas coletadas na árvore mutável e na persistente; na
+   persistente, ciclos de marcar/coletar/desfazer, bifurcações com uma coleta no ramo e,
+   para comparar, a cópia integral da árvore. O programa falha se desfazer ou o ramo
+   alterarem o estado da sessão de origem. */
+static void medirHistorico(size_t n) {
+    // textos do zero e suspeitos antes das pistas, como num mapa carregado: os vetores por
+    // suspeito da sessão (zerados na bifurcação) vão até o maior id de suspeito
+    liberarTextos();
+    IdTexto suspeitos[TOTAL_SUSPEITOS];
+    int evidencias[TOTAL_SUSPEITOS] = { 0 };
+    char nome[32];
+    for (int s = 0; s < TOTAL_SUSPEITOS; s++) {
+        snprintf(nome, sizeof(nome), "Suspeito %d", s);
+        suspeitos[s] = internar(nome);
+    }
+    IdTexto *ids = idsPistas(n, "aleatórias");
+    TabelaHash hash;
+    inicializarHash(&hash);
+    for (size_t i = 0; i < n; i++) {
+        // suspeitos de número baixo recebem mais pistas: o ranking tem um líder claro
+        int s = (int) (i % TOTAL_SUSPEITOS) % (1 + (int) (i % 7));
+        inserirNaHashId(&hash, ids[i], suspeitos[s]);
+        evidencias[s]++;
+    }
+
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    unsigned long reps = repeticoes(n), a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        Sessao sessao;
+        iniciarSessao(&sessao);
+        for (size_t i = 0; i < n; i++) coletarPista(&sessao, &hash, ids[i]);
+        liberarSessao(&sessao);
+        arenaResetar(&arena);
+    }
+    relatar("coletarPista (árvore mutável)", n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+
+    Sessao sessao;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        if (r) liberarSessao(&sessao);
+        iniciarSessao(&sessao);
+        ativarHistorico(&sessao);
+        for (size_t i = 0; i < n; i++) coletarPista(&sessao, &hash, ids[i]);
+    }
+    relatar("coletarPista (persistente)", n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+    IdTexto lider = suspeitoMaisProvavel(&sessao);
+    conferirSessao(&sessao, "a carga", n, suspeitos, evidencias, lider);
+
+    reps = repeticoes(n) / 4 + 1;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        marcarPasso(&sessao);
+        coletarPista(&sessao, &hash, ids[aleatorio() % n]);
+        desfazerPasso(&sessao);
+    }
+    relatar("marcar + coletar + desfazerPasso", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    conferirSessao(&sessao, "desfazer", n, suspeitos, evidencias, lider);
+
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        Sessao ramo;
+        bifurcarSessao(&sessao, &ramo);
+        coletarPista(&ramo, &hash, ids[aleatorio() % n]);
+        liberarSessao(&ramo);
+    }
+    relatar("bifurcarSessao + coleta no ramo", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    conferirSessao(&sessao, "bifurcar", n, suspeitos, evidencias, lider);
+
+    reps = repeticoes(n) / 64 + 1;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) soltarPistas(copiarPistasPersistente(sessao.raizPistas));
+    relatar("cópia integral da árvore", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    liberarSessao(&sessao);
+    liberarHash(&hash);
+    free(ids);
+}
+
+/* medirRanking: n suspeitos com evidências em distribuição desigual (ids baixos recebem
+   mais), depois consultas top-10 sobre o heap já montado */
+static void medirRanking(size_t n) {
+    enum { TOPO = 10 };
+    Sessao sessao;
+    unsigned long reps = repeticoes(n);
+    unsigned long a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        if (r) liberarSessao(&sessao);
+        iniciarSessao(&sessao);
+        for (size_t i = 0; i < n; i++) {
+            IdTexto sus = (IdTexto) (1 + (aleatorio() % n) * (aleatorio() % n) / n);
+            reservarSuspeito(&sessao, sus);
+            sessao.evidencias[sus]++;
+            registrarEvidencia(&sessao, sus);
+        }
+    }
+    relatar("registrarEvidencia (heap)", n, agoraNs() - t0, reps * n, totalAlocacoes - a0);
+
+    IdTexto topo[TOPO];
+    volatile size_t acumulado = 0;
+    reps = OPS_MINIMAS;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) acumulado += suspeitosMaisProvaveis(&sessao, topo, TOPO);
+    relatar("suspeitosMaisProvaveis (top-10)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    liberarSessao(&sessao);
+}
+
+/* MansaoGerada: mansão completa de n salas em layout plano (a sala i tem filhos 2i+1 e
+   2i+2) e 1 em 3 com pista; 'mansao' aponta para 'plana', então a estrutura não se move */
+typedef struct MansaoGerada {
+    SalaPlana *salas;
+    uint32_t *nomes;
+    MansaoPlana plana;
+    Mansao mansao;
+} MansaoGerada;
+
+/* gerarMansao: monta a mansão de n salas; com 'hash', a pista da sala i aponta para o
+   suspeito i % TOTAL_SUSPEITOS */
+static void gerarMansao(size_t n, TabelaHash *hash, MansaoGerada *g) {
+    g->salas = (SalaPlana*) malloc(n * sizeof(SalaPlana));
+    g->nomes = (uint32_t*) malloc(n * sizeof(uint32_t));
+    char texto[48];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(texto, sizeof(texto), "Sala %zu", i);
+        g->nomes[i] = internar(texto);
+        g->salas[i].esquerda = 2 * i + 1 < n ? (uint32_t) (2 * i + 1) : SALA_NENHUMA;
+        g->salas[i].direita = 2 * i + 2 < n ? (uint32_t) (2 * i + 2) : SALA_NENHUMA;
+        g->salas[i].pista = SEM_TEXTO;
+        if (i % 3 == 0) {
+            snprintf(texto, sizeof(texto), "Pista da sala %zu", i);
+            g->salas[i].pista = internar(texto);
+            if (!hash) continue;
+            snprintf(texto, sizeof(texto), "Suspeito %zu", i % TOTAL_SUSPEITOS);
+            inserirNaHashId(hash, g->salas[i].pista, internar(texto));
+        }
+    }
+    memset(&g->plana, 0, sizeof(g->plana));
+    g->plana.salas = g->salas;
+    g->plana.nomes = g->nomes;
+    g->plana.total = (uint32_t) n;
+    Mansao mansao = { NULL, &g->plana, NULL };
+    g->mansao = mansao;
+}
+
+static void liberarMansaoGerada(MansaoGerada *g) {
+    free(g->salas);
+    free(g->nomes);
+}
+
+/* medirSessoes: mansão gerada de n salas e caminhadas aleatórias da entrada até uma folha */
+static void medirSessoes(size_t n) {
+    TabelaHash hash;
+    inicializarHash(&hash);
+    MansaoGerada gerada;
+    gerarMansao(n, &hash, &gerada);
+    uint32_t profundidade = 0;
+    for (size_t k = n; k > 1; k /= 2) profundidade++;
+
+    enum { ROTEIROS = 1024 };
+    static char roteiros[ROTEIROS][64];
+    for (int r = 0; r < ROTEIROS; r++) {
+        uint32_t passos = profundidade < 62 ? profundidade : 62, k = 0;
+        for (; k < passos; k++) roteiros[r][k] = aleatorio() & 1 ? 'e' : 'd';
+        roteiros[r][k++] = 's';
+        roteiros[r][k] = '\0';
+    }
+
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    Saida saida = { NULL, 0, 0, 1 };
+    unsigned long reps = OPS_MINIMAS / 10, a0 = totalAlocacoes;
+    volatile int acumulado = 0;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        Sessao sessao;
+        iniciarSessao(&sessao);
+        sessao.roteiro = roteiros[r % ROTEIROS];
+        sessao.saida = &saida;
+        explorarSalas(&gerada.mansao, &sessao, &hash);
+        acumulado += julgarAcusacao(&sessao, "Suspeito 3");
+        liberarSessao(&sessao);
+        arenaResetar(&arena);
+    }
+    relatar("sessão roteirizada (silenciosa)", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    liberarHash(&hash);
+    liberarMansaoGerada(&gerada);
+}
+
+/* medirRotas: índice de rotas da mansão gerada de n salas; consultas de ancestral comum
+   entre salas aleatórias e da pista nova mais próxima */
+static void medirRotas(size_t n) {
+    MansaoGerada gerada;
+    gerarMansao(n, NULL, &gerada);
+    MapaRotas rotas;
+    unsigned long a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    construirRotas(&gerada.mansao, &rotas);
+    relatar("construirRotas (por sala)", n, agoraNs() - t0, n, totalAlocacoes - a0);
+
+    unsigned long reps = OPS_MINIMAS;
+    volatile uint32_t acumulado = 0;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++)
+        acumulado += ancestralComum(&rotas, (uint32_t) (aleatorio() % n), (uint32_t) (aleatorio() % n));
+    relatar("ancestralComum", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+
+    Sessao sessao;   // sessão sem pistas: a mais próxima está a no máximo 2 passos
+    iniciarSessao(&sessao);
+    reps = OPS_MINIMAS / 10;
+    a0 = totalAlocacoes;
+    t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++)
+        acumulado += pistaNovaMaisProxima(&rotas, &sessao, (uint32_t) (aleatorio() % n));
+    relatar("pistaNovaMaisProxima", n, agoraNs() - t0, reps, totalAlocacoes - a0);
+    liberarSessao(&sessao);
+    liberarRotas(&rotas);
+    liberarMansaoGerada(&gerada);
+}
+
+/* medirConversao: mapa em texto com n salas (1 em 3 com pista) e as associações declaradas
+   em duas rodadas, a segunda redeclarando 1 pista em 2 com outro suspeito (vale a última),
+   convertido e carregado de volta. O programa falha se o conjunto de associações carregado
+   não for exatamente o declarado. */
+static void medirConversao(size_t n) {
+    char texto[] = "/tmp/benchmark_mapaXXXXXX", binario[] = "/tmp/benchmark_mapaXXXXXX";
+    int fdTexto = mkstemp(texto), fdBinario = mkstemp(binario);
+    FILE *f = fdTexto >= 0 ? fdopen(fdTexto, "w") : NULL;
+    if (!f || fdBinario < 0) { perror("mkstemp"); exit(EXIT_FAILURE); }
+    close(fdBinario);
+    for (size_t i = 0; i < n; i++) {
+        if (i % 3 == 0) fprintf(f, "sala Sala %zu | Pista da sala %zu\n", i, i);
+        else fprintf(f, "sala Sala %zu\n", i);
+    }
+    for (size_t i = 0; 2 * i + 1 < n; i++) {
+        fprintf(f, "liga %zu %zu ", i, 2 * i + 1);
+        if (2 * i + 2 < n) fprintf(f, "%zu\n", 2 * i + 2);
+        else fputs("-\n", f);
+    }
+    size_t linhas = n + n / 2;
+    for (int rodada = 0; rodada < 2; rodada++) {
+        for (size_t i = 0; i < n; i += 3) {
+            if (rodada && i % 2) continue;
+            fprintf(f, "associa Pista da sala %zu | Suspeito %zu\n", i, (i + (size_t) rodada) % TOTAL_SUSPEITOS);
+            linhas++;
+        }
+    }
+    if (fclose(f) != 0) { perror(texto); exit(EXIT_FAILURE); }
+
+    unsigned long a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    if (converterMapaTexto(texto, binario) != 0) exit(EXIT_FAILURE);
+    relatar("converterMapaTexto (por linha)", n, agoraNs() - t0, linhas, totalAlocacoes - a0);
+
+    TabelaHash hash;
+    inicializarHash(&hash);
+    MapaBinario mapa;
+    if (carregarMapa(binario, &mapa, &hash, NULL) != 0) exit(EXIT_FAILURE);
+    char pista[48], suspeito[48];
+    size_t pistas = 0;
+    for (size_t i = 0; i < n; i += 3, pistas++) {
+        snprintf(pista, sizeof(pista), "Pista da sala %zu", i);
+        snprintf(suspeito, sizeof(suspeito), "Suspeito %zu", (i + (i % 2 == 0)) % TOTAL_SUSPEITOS);
+        IdTexto achado = encontrarSuspeitoId(&hash, buscarTexto(pista));
+        if (achado != buscarTexto(suspeito)) {
+            fprintf(stderr, "conversão: \"%s\" -> \"%s\" (esperado \"%s\")\n", pista, textoDe(achado), suspeito);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (hash.tamanho != pistas) {
+        fprintf(stderr, "conversão: %zu associações carregadas (esperadas %zu)\n", hash.tamanho, pistas);
+        exit(EXIT_FAILURE);
+    }
+    fecharMapa(&mapa);
+    liberarHash(&hash);
+    unlink(texto);
+    unlink(binario);
+}
+
+/* Estresse da tabela concorrente: a pista ids[k] só pode apontar para ids[k] ou
+   ids[k] | BIT_ALTERNADO; as primeiras 'inseridas' estão na tabela e nunca somem */
+#define BIT_ALTERNADO 0x80000000u
+
+typedef struct Estresse {
+    TabelaConcorrente *tabela;
+    const IdTexto *ids;
+    size_t n;
+    atomic_size_t inseridas;
+    atomic_int ativos;          // leitores que ainda não fizeram as suas leituras
+} Estresse;
+
+typedef struct LeitorEstresse {
+    Estresse *e;
+    pthread_t thread;
+    uint64_t semente;
+    unsigned long leituras, violacoes;
+    double ns;
+} LeitorEstresse;
+
+static void* lerSobEstresse(void *arg) {
+    LeitorEstresse *l = (LeitorEstresse*) arg;
+    Estresse *e = l->e;
+    uint64_t x = l->semente;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < l->leituras; r++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        size_t k = (size_t) (x % e->n);
+        size_t presentes = atomic_load_explicit(&e->inseridas, memory_order_acquire);
+        IdTexto sus = buscarConcorrente(e->tabela, e->ids[k]);
+        if (sus == SEM_TEXTO ? k < presentes : (sus & ~BIT_ALTERNADO) != e->ids[k]) l->violacoes++;
+    }
+    l->ns = agoraNs() - t0;
+    atomic_fetch_sub_explicit(&e->ativos, 1, memory_order_release);
+    liberarLeitorConcorrente();
+    return NULL;
+}
+
+static void medirTabelaConcorrente(size_t n) {
+    if (n < 2) return;
+    IdTexto *ids = idsPistas(n, "aleatórias");
+    TabelaConcorrente tc;
+    iniciarConcorrente(&tc);
+    Estresse e;
+    e.tabela = &tc;
+    e.ids = ids;
+    e.n = n;
+    for (size_t k = 0; k < n / 2; k++) inserirConcorrente(&tc, ids[k], ids[k]);
+    atomic_init(&e.inseridas, n / 2);
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    int leitores = nucleos > 4 ? (int) nucleos : 4;
+    atomic_init(&e.ativos, leitores);
+    LeitorEstresse *ls = (LeitorEstresse*) calloc((size_t) leitores, sizeof(LeitorEstresse));
+    for (int i = 0; i < leitores; i++) {
+        ls[i].e = &e;
+        ls[i].semente = aleatorio() | 1;
+        ls[i].leituras = OPS_MINIMAS / (unsigned long) leitores;
+        pthread_create(&ls[i].thread, NULL, lerSobEstresse, &ls[i]);
+    }
+
+    // escritor: insere a segunda metade e alterna os suspeitos enquanto houver leitores
+    // (e até somar pelo menos OPS_MINIMAS / 10 escritas)
+    unsigned long escritas = 0, a0 = totalAlocacoes;
+    double t0 = agoraNs();
+    for (size_t k = n / 2; k < n; k++, escritas++) {
+        inserirConcorrente(&tc, ids[k], ids[k]);
+        atomic_store_explicit(&e.inseridas, k + 1, memory_order_release);
+    }
+    for (size_t k = 0; escritas < OPS_MINIMAS / 10 || atomic_load_explicit(&e.ativos, memory_order_acquire) > 0;
+         k = k + 1 < n ? k + 1 : 0, escritas++)
+        inserirConcorrente(&tc, ids[k], ids[k] ^ (escritas & 1 ? BIT_ALTERNADO : 0));
+    double ns = agoraNs() - t0;
+    unsigned long allocs = totalAlocacoes - a0;
+
+    unsigned long leituras = 0, violacoes = 0;
+    double nsLeitura = 0;
+    for (int i = 0; i < leitores; i++) {
+        pthread_join(ls[i].thread, NULL);
+        leituras += ls[i].leituras;
+        violacoes += ls[i].violacoes;
+        nsLeitura += ls[i].ns;
+    }
+    relatar("inserirConcorrente (sob leitura)", n, ns, escritas, allocs);
+    relatar("buscarConcorrente (sob escrita)", n, nsLeitura, leituras, 0);
+    if (violacoes) {
+        fprintf(stderr, "tabela concorrente: %lu leituras inválidas em %lu (n = %zu, %d leitores)\n",
+                violacoes, leituras, n, leitores);
+        exit(EXIT_FAILURE);
+    }
+    free(ls);
+    liberarConcorrente(&tc);
+    free(ids);
+}
+
+/* medirAssociacoesFixas: as 8 pistas da mansão fixa no hash perfeito e na tabela dinâmica */
+static void medirAssociacoesFixas(void) {
+    TabelaHash fixa, dinamica;
+    inicializarHash(&fixa);
+    inicializarHash(&dinamica);
+    unsigned long a0;
+    if (usarAssociacoesFixas(&fixa) != 0) {
+        liberarHash(&fixa);
+        liberarHash(&dinamica);
+        return;
+    }
+#ifdef COM_ASSOCIACOES_FIXAS
+    IdTexto pistas[TOTAL_ASSOCIACOES_FIXAS];
+    for (uint32_t i = 0; i < TOTAL_ASSOCIACOES_FIXAS; i++) {
+        pistas[i] = internar(ASSOCIACOES_FIXAS[i].pista);
+        inserirNaHashId(&dinamica, pistas[i], internar(ASSOCIACOES_FIXAS[i].suspeito));
+    }
+    const TabelaHash *tabelas[2] = { &fixa, &dinamica };
+    const char *nomes[2] = { "encontrarSuspeitoId (hash perfeito)", "encontrarSuspeitoId (dinâmica)" };
+    for (int t = 0; t < 2; t++) {
+        unsigned long reps = OPS_MINIMAS;
+        volatile IdTexto acumulado = 0;
+        a0 = totalAlocacoes;
+        double t0 = agoraNs();
+        for (unsigned long r = 0; r < reps; r++)
+            acumulado += encontrarSuspeitoId(tabelas[t], pistas[r % TOTAL_ASSOCIACOES_FIXAS]);
+        relatar(nomes[t], TOTAL_ASSOCIACOES_FIXAS, agoraNs() - t0, reps, totalAlocacoes - a0);
+    }
+#endif
+    liberarHash(&fixa);
+    liberarHash(&dinamica);
+    liberarTextos();
+}
+
+/* medirMansaoFixa: a mansão do jogo (8 salas) percorrida até o Porão */
+static void medirMansaoFixa(void) {
+    TabelaHash hash;
+    inicializarHash(&hash);
+    Sala *hall = montarMansaoFixa(&hash, NULL);
+    Mansao mansao = { hall, NULL, NULL };
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    Saida saida = { NULL, 0, 0, 1 };
+    unsigned long reps = OPS_MINIMAS, a0 = totalAlocacoes;
+    volatile int acumulado = 0;
+    double t0 = agoraNs();
+    for (unsigned long r = 0; r < reps; r++) {
+        Sessao sessao;
+        iniciarSessao(&sessao);
+        sessao.roteiro = "eees";
+        sessao.saida = &saida;
+        explorarSalas(&mansao, &sessao, &hash);
+        acumulado += julgarAcusacao(&sessao, "Sr. Rocha");
+        liberarSessao(&sessao);
+        arenaResetar(&arena);
+    }
+    relatar("sessão na mansão fixa (silenciosa)", 8, agoraNs() - t0, reps, totalAlocacoes - a0);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    liberarSalas(hall);
+    liberarHash(&hash);
+    liberarTextos();
+}
+
+/* ------------------ Programa principal ------------------ */
+int main(int argc, char *argv[]) {
+    size_t maximo = 1000000;
+    if (argc == 3 && strcmp(argv[1], "--max") == 0) {
+        maximo = (size_t) strtoull(argv[2], NULL, 10);
+    } else if (argc != 1) {
+        fprintf(stderr, "Uso: %s [--max n]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    imprimirCaso("caso");
+    printf(" %9s %12s %12s %10s\n", "n", "ns/op", "allocs/op", "pico +KB");
+    ISOLADO(medirAssociacoesFixas());
+    ISOLADO(medirMansaoFixa());
+    for (size_t n = 10; n <= maximo; n *= 10) {
+        ISOLADO(medirInsercao(n, "aleatórias"));
+        ISOLADO(medirInsercao(n, "ordenadas"));
+        ISOLADO(medirInsercao(n, "repetidas"));
+        ISOLADO(medirCargaEmLote(n, "aleatórias"));
+        ISOLADO(medirCargaEmLote(n, "ordenadas"));
+        ISOLADO(medirCargaEmLote(n, "repetidas"));
+        ISOLADO(medirOrdem(n));
+        ISOLADO(medirHashTextos(n));
+        ISOLADO(medirBusca(n, 2));
+        ISOLADO(medirBusca(n, 4));
+        ISOLADO(medirBusca(n, 6));
+        ISOLADO(medirBusca(n, 7));   // carga máxima da tabela (7/8)
+        ISOLADO(medirAcusacao(n));
+        ISOLADO(medirPontuacao(n));
+        ISOLADO(medirRanking(n));
+        ISOLADO(medirHistorico(n));
+        ISOLADO(medirSessoes(n));
+        ISOLADO(medirRotas(n));
+        ISOLADO(medirConversao(n));
+        ISOLADO(medirTabelaConcorrente(n));   // cada caso começa com a tabela de textos vazia do pai
+    }
+    // limiar do filtro: os erros passam a ganhar com ele perto de FILTRO_ENTRADAS_MINIMAS
+    for (size_t n = FILTRO_ENTRADAS_MINIMAS / 4; n <= FILTRO_ENTRADAS_MINIMAS * 4 && n <= maximo; n *= 2)
+        ISOLADO(medirBusca(n, 7));
+    return 0;
+}
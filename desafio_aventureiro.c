@@ -6,7 +6,8 @@
   Descrição:
     Expande o sistema da mansão (árvore binária)
     para permitir coleta e organização de pistas
-    em uma árvore BST, exibidas em ordem alfabética.
+    em uma árvore BST balanceada (AVL), exibidas
+    em ordem alfabética.
 */
 
 #include <stdio.h>
@@ -23,6 +24,7 @@ typedef struct sala {
 
 typedef struct pistaNode {
     char pista[100];
+    int altura; // altura da subárvore (folha = 1), para balanceamento AVL
     struct pistaNode *esquerda;
     struct pistaNode *direita;
 } PistaNode;
@@ -31,6 +33,11 @@ typedef struct pistaNode {
 Sala* criarSala(const char *nome, const char *pista);
 PistaNode* criarPistaNode(const char *pista);
 PistaNode* inserirPista(PistaNode *raiz, const char *pista);
+int alturaPista(PistaNode *n);
+void atualizarAltura(PistaNode *n);
+PistaNode* rotacionarDireita(PistaNode *y);
+PistaNode* rotacionarEsquerda(PistaNode *x);
+PistaNode* balancearPista(PistaNode *n);
 void explorarSalasComPistas(Sala *atual, PistaNode **raizPistas);
 void exibirPistas(PistaNode *raiz);
 void liberarSalas(Sala *raiz);
@@ -97,19 +104,68 @@ PistaNode* criarPistaNode(const char *pista) {
         exit(1);
     }
     strcpy(novo->pista, pista);
+    novo->altura = 1;
     novo->esquerda = NULL;
     novo->direita = NULL;
     return novo;
 }
 
-/* -------- Insere uma pista na árvore BST -------- */
+/* -------- Utilitários AVL (altura e rotações) -------- */
+int alturaPista(PistaNode *n) {
+    return n ? n->altura : 0;
+}
+
+void atualizarAltura(PistaNode *n) {
+    int he = alturaPista(n->esquerda);
+    int hd = alturaPista(n->direita);
+    n->altura = (he > hd ? he : hd) + 1;
+}
+
+PistaNode* rotacionarDireita(PistaNode *y) {
+    PistaNode *x = y->esquerda;
+    y->esquerda = x->direita;
+    x->direita = y;
+    atualizarAltura(y);
+    atualizarAltura(x);
+    return x;
+}
+
+PistaNode* rotacionarEsquerda(PistaNode *x) {
+    PistaNode *y = x->direita;
+    x->direita = y->esquerda;
+    y->esquerda = x;
+    atualizarAltura(x);
+    atualizarAltura(y);
+    return y;
+}
+
+PistaNode* balancearPista(PistaNode *n) {
+    atualizarAltura(n);
+    int fator = alturaPista(n->esquerda) - alturaPista(n->direita);
+    if (fator > 1) {
+        if (alturaPista(n->esquerda->esquerda) < alturaPista(n->esquerda->direita))
+            n->esquerda = rotacionarEsquerda(n->esquerda);
+        return rotacionarDireita(n);
+    }
+    if (fator < -1) {
+        if (alturaPista(n->direita->direita) < alturaPista(n->direita->esquerda))
+            n->direita = rotacionarDireita(n->direita);
+        return rotacionarEsquerda(n);
+    }
+    return n;
+}
+
+/* -------- Insere uma pista na árvore AVL -------- */
 PistaNode* inserirPista(PistaNode *raiz, const char *pista) {
     if (raiz == NULL) return criarPistaNode(pista);
-    if (strcmp(pista, raiz->pista) < 0)
+    int cmp = strcmp(pista, raiz->pista); // uma única comparação por nível
+    if (cmp == 0)
+        return raiz; // pista repetida: nada a fazer
+    if (cmp < 0)
         raiz->esquerda = inserirPista(raiz->esquerda, pista);
-    else if (strcmp(pista, raiz->pista) > 0)
+    else
         raiz->direita = inserirPista(raiz->direita, pista);
-    return raiz;
+    return balancearPista(raiz);
 }
 
 /* -------- Exploração interativa -------- */
@@ -1,310 +1,308 @@
 /*
   Detective Quest - Capítulo Final: Acusação de Suspeitos
   - Exploração de mansão (árvore binária)
-  - Coleta de pistas em BST
-  - Associação pista -> suspeito via tabela hash (encadeamento)
-  - Julgamento final: acusação e verificação (>=2 pistas)
+  - Coleta de pistas em BST balanceada (AVL), percorrida sem recursão (iterador/visitante);
+    lotes de pistas são ordenados em paralelo e ligados numa árvore balanceada em O(n)
+  - Estatísticas de ordem na árvore de pistas (tamanho e ocorrências por subárvore): k-ésima
+    pista, posição alfabética e contagem de intervalo em O(log n), listagem paginada
+  - Histórico (--historico): árvore de pistas persistente (cópia do caminho, nós com contagem
+    de referências); desfazer passos e bifurcar a investigação sem copiar a árvore
+  - Índice de prefixos (trie radix compacta) das pistas coletadas, montado na primeira
+    consulta: busca por prefixo e por intervalo alfabético, com contagem de ocorrências
+  - Associação pista -> suspeito via tabela hash (endereçamento aberto, Robin Hood); as
+    associações fixas vêm de um hash perfeito mínimo gerado (associacoes_fixas.h)
+  - Filtro de Bloom em blocos de 64 bytes na frente das associações (a partir de
+    FILTRO_ENTRADAS_MINIMAS): pistas sem suspeito são rejeitadas lendo uma linha de cache,
+    sem sondar a tabela
+  - Hash de textos vetorizado (escalar/SSE2/AVX2, escolhido em tempo de execução, mesmo
+    resultado em todos) e prefixo de 8 bytes nos nós de pista para comparar sem strcmp
+  - Julgamento final: acusação e verificação (>=2 pistas) em O(1) via contadores por suspeito
+  - Processo do caso (--ponderado): pistas implicam vários suspeitos com pesos; pistas
+    coletadas num bitset e cada suspeito em planos de bits do peso, todos pontuados de uma
+    vez com AND + popcount (escalar/POPCNT/AVX2, escolhido em tempo de execução)
+  - Ranking dos suspeitos num heap máximo indexado, atualizado a cada pista (top-k em O(k log k))
+  - Arena de memória por sessão: salas, pistas e tabela liberadas de uma vez
+  - Textos internados: pistas, suspeitos e salas circulam como ids de 32 bits
+  - Mapas em arquivo binário (.dqm) mapeados com mmap e usados sem cópia, ou paginados:
+    salas lidas sob demanda (pread) num cache LRU de tamanho fixo, para mapas maiores que a RAM
+  - Layout plano da mansão (vetores contíguos, índices de 32 bits) como alternativa aos ponteiros
+  - Rotas (--dicas): salas numeradas em pré-ordem com pai e profundidade; ancestral comum
+    por tabela esparsa em O(1), menor caminho entre salas e busca da pista nova mais próxima
+  - Instantâneo binário da sessão (.dqs): sala atual, pistas e contadores gravados de uma vez
+    e lidos com mmap para retomar a investigação
+  - Modo roteiro/lote: sessões gravadas reproduzidas sem interação, com saída em buffer
+  - Motor multi-thread: mansão, tabela hash e textos compartilhados somente para leitura;
+    com --correcoes, a tabela pista -> suspeito aceita escritas durante o lote (leituras sem
+    trava, par gravado numa palavra atômica, versões antigas liberadas por épocas)
+  - Estatísticas opcionais (-DDETECTIVE_ESTATISTICAS): sondagens da tabela, árvores,
+    alocações por estrutura e latência por passo; sem a flag não geram código
+
+  O motor fica em mestre/ (um par .h/.c por estrutura); este arquivo só interpreta a linha
+  de comando.
+
+  Compilação:   make                (desafio_mestre e benchmark_mestre)
+  Estatísticas: make clean && make CPPFLAGS=-DDETECTIVE_ESTATISTICAS
+  Testes:       make test           (testes_mestre.c; benchmark_mestre só mede tempo)
+  Sem make:     gcc -O2 -pthread com desafio_mestre.c e todos os .c de mestre/
+
+  Uso:
+    ./desafio_mestre                               mansão fixa do código
+    ./desafio_mestre --mapa mansao.dqm             joga no mapa binário
+    ./desafio_mestre --mapa m.dqm --paginada [--cache n]   lê as salas sob demanda (n residentes)
+    ./desafio_mestre --plana [--largura]           mansão fixa no layout plano (pré-ordem ou largura)
+    ./desafio_mestre --info ...                    mostra salas, profundidade e memória do layout
+    ./desafio_mestre --roteiro eeds --acusar "Sr. Rocha"   uma sessão roteirizada
+    ./desafio_mestre ... --prefixo "Marca"          lista, no final, as pistas com o prefixo
+    ./desafio_mestre ... --pagina 3 / --posicao "Marca"   uma página das pistas / posição de uma pista
+    ./desafio_mestre ... --salvar s.dqs / --retomar s.dqs   grava / continua uma sessão
+    ./desafio_mestre ... --dicas                    (v) volta uma sala, (r) rota até a pista nova mais próxima
+    ./desafio_mestre ... --ponderado                pontuação ponderada de todos os suspeitos (implicações)
+    ./desafio_mestre ... --historico                (u) desfaz o passo, (b) guarda uma bifurcação, (a) volta a ela
+    ./desafio_mestre --lote sessoes.txt [--silencioso]     uma sessão por linha: "eeds | Sr. Rocha"
+    ./desafio_mestre --lote sessoes.txt --threads 8        sessões em paralelo (0 = todos os núcleos)
+    ./desafio_mestre --lote s.txt --correcoes c.txt  associações "pista | suspeito" aplicadas durante o lote
+    ./desafio_mestre --converter mansao.txt m.dqm  gera o binário a partir do texto
+    ./desafio_mestre --gerar-hash mansao.txt associacoes_fixas.h   hash perfeito das associações
+  Com estatísticas, o relatório sai no stderr ao final e com (x) durante a exploração.
 */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
+#include "mestre/associacoes.h"
+#include "mestre/concorrente.h"
+#include "mestre/estatisticas.h"
+#include "mestre/exploracao.h"
+#include "mestre/instantaneo.h"
+#include "mestre/lote.h"
+#include "mestre/paginada.h"
+#include "mestre/textos.h"
 
-#define MAX_NOME 64
-#define MAX_PISTA 128
-#define HASH_SIZE 101   // número primo razoável para hash
-
-/* ------------------ Estruturas ------------------ */
-
-/* Nó da árvore da mansão (cada cômodo) */
-typedef struct Sala {
-    char nome[MAX_NOME];
-    char pista[MAX_PISTA]; // string vazia se não tiver pista
-    struct Sala *esquerda;
-    struct Sala *direita;
-} Sala;
-
-/* Nó da BST de pistas (armazenamos contagem para pistas repetidas) */
-typedef struct PistaNode {
-    char pista[MAX_PISTA];
-    int ocorrencias; // quantas vezes coletada
-    struct PistaNode *esquerda;
-    struct PistaNode *direita;
-} PistaNode;
-
-/* Entrada na tabela hash (encadeamento) - mapeia pista -> suspeito */
-typedef struct HashEntry {
-    char pista[MAX_PISTA];
-    char suspeito[MAX_NOME];
-    struct HashEntry *proximo;
-} HashEntry;
-
-/* ------------------ Protótipos (requisitos/documentação) ------------------ */
-
-/* criarSala() – cria dinamicamente um cômodo com ou sem pista. */
-Sala* criarSala(const char *nome, const char *pista);
-
-/* explorarSalas() – navega pela árvore e ativa o sistema de pistas. */
-void explorarSalas(Sala *atual, PistaNode **raizPistas, HashEntry *hash[]);
-
-/* inserirPista() / adicionarPista() – insere a pista coletada na árvore de pistas. */
-PistaNode* inserirPista(PistaNode *raiz, const char *pista);
-
-/* inserirNaHash() – insere associação pista/suspeito na tabela hash. */
-void inserirNaHash(HashEntry *hash[], const char *pista, const char *suspeito);
-
-/* encontrarSuspeito() – consulta o suspeito correspondente a uma pista. */
-const char* encontrarSuspeito(HashEntry *hash[], const char *pista);
-
-/* exibirPistas() – imprime a árvore de pistas em ordem alfabética. */
-void exibirPistas(PistaNode *raiz);
-
-/* verificarSuspeitoFinal() – conduz à fase de julgamento final.
-   Retorna o número de pistas que apontam para o suspeito acusado. */
-int verificarSuspeitoFinal(PistaNode *raiz, HashEntry *hash[], const char *acusado);
-
-/* utilitários: hash, liberar memória, strip newline */
-unsigned long hash_djb2(const char *str);
-void liberarSalas(Sala *raiz);
-void liberarPistas(PistaNode *raiz);
-void liberarHash(HashEntry *hash[]);
-void strip_newline(char *s);
-
-/* ------------------ Implementação ------------------ */
-
-/* criarSala: aloca e inicializa uma sala (cômodo) dinamicamente */
-Sala* criarSala(const char *nome, const char *pista) {
-    Sala *s = (Sala*) malloc(sizeof(Sala));
-    if (!s) { perror("malloc"); exit(EXIT_FAILURE); }
-    strncpy(s->nome, nome, MAX_NOME-1); s->nome[MAX_NOME-1] = '\0';
-    if (pista) {
-        strncpy(s->pista, pista, MAX_PISTA-1); s->pista[MAX_PISTA-1] = '\0';
-    } else {
-        s->pista[0] = '\0';
+/* ------------------ Programa principal ------------------ */
+int main(int argc, char *argv[]) {
+    if (argc == 4 && strcmp(argv[1], "--converter") == 0) {
+        int r = converterMapaTexto(argv[2], argv[3]);
+        liberarTextos();
+        if (r == 0) printf("Mapa binário gravado em %s\n", argv[3]);
+        return r == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    s->esquerda = s->direita = NULL;
-    return s;
-}
-
-/* inserirPista: insere pista na BST. Se já existe, incrementa ocorrencias. */
-PistaNode* inserirPista(PistaNode *raiz, const char *pista) {
-    if (!pista || pista[0] == '\0') return raiz;
-    if (raiz == NULL) {
-        PistaNode *n = (PistaNode*) malloc(sizeof(PistaNode));
-        if (!n) { perror("malloc"); exit(EXIT_FAILURE); }
-        strncpy(n->pista, pista, MAX_PISTA-1); n->pista[MAX_PISTA-1] = '\0';
-        n->ocorrencias = 1;
-        n->esquerda = n->direita = NULL;
-        return n;
+    if (argc == 4 && strcmp(argv[1], "--gerar-hash") == 0) {
+        int r = gerarHashPerfeito(argv[2], argv[3]);
+        liberarTextos();
+        if (r == 0) printf("Hash perfeito gravado em %s\n", argv[3]);
+        return r == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    int cmp = strcmp(pista, raiz->pista);
-    if (cmp == 0) {
-        raiz->ocorrencias++;
-    } else if (cmp < 0) {
-        raiz->esquerda = inserirPista(raiz->esquerda, pista);
-    } else {
-        raiz->direita = inserirPista(raiz->direita, pista);
+    const char *caminhoMapa = NULL, *caminhoLote = NULL, *roteiro = NULL, *acusadoRoteiro = NULL;
+    const char *prefixo = NULL, *caminhoSalvar = NULL, *caminhoRetomar = NULL, *caminhoCorrecoes = NULL;
+    const char *posicao = NULL;
+    size_t pagina = 0;
+    int usarPlana = 0, ordemPlana = ORDEM_PREORDEM, mostrarInfo = 0, silencioso = 0, threads = 1;
+    int paginar = 0, dicas = 0, ponderado = 0, historico = 0;
+    uint32_t cacheSalas = CACHE_SALAS_PADRAO;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mapa") == 0 && i + 1 < argc) caminhoMapa = argv[++i];
+        else if (strcmp(argv[i], "--plana") == 0) usarPlana = 1;
+        else if (strcmp(argv[i], "--largura") == 0) ordemPlana = ORDEM_LARGURA;
+        else if (strcmp(argv[i], "--info") == 0) mostrarInfo = 1;
+        else if (strcmp(argv[i], "--paginada") == 0) paginar = 1;
+        else if (strcmp(argv[i], "--dicas") == 0) dicas = 1;
+        else if (strcmp(argv[i], "--ponderado") == 0) ponderado = 1;
+        else if (strcmp(argv[i], "--historico") == 0) historico = 1;
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) cacheSalas = (uint32_t) strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc) caminhoLote = argv[++i];
+        else if (strcmp(argv[i], "--correcoes") == 0 && i + 1 < argc) caminhoCorrecoes = argv[++i];
+        else if (strcmp(argv[i], "--roteiro") == 0 && i + 1 < argc) roteiro = argv[++i];
+        else if (strcmp(argv[i], "--acusar") == 0 && i + 1 < argc) acusadoRoteiro = argv[++i];
+        else if (strcmp(argv[i], "--prefixo") == 0 && i + 1 < argc) prefixo = argv[++i];
+        else if (strcmp(argv[i], "--pagina") == 0 && i + 1 < argc) pagina = (size_t) strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--posicao") == 0 && i + 1 < argc) posicao = argv[++i];
+        else if (strcmp(argv[i], "--salvar") == 0 && i + 1 < argc) caminhoSalvar = argv[++i];
+        else if (strcmp(argv[i], "--retomar") == 0 && i + 1 < argc) caminhoRetomar = argv[++i];
+        else if (strcmp(argv[i], "--silencioso") == 0) silencioso = 1;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Uso: %s [--mapa arquivo.dqm [--paginada [--cache salas]] | --plana [--largura]] [--info] [--dicas] [--ponderado] [--historico]\n"
+                            "          [--roteiro movimentos [--acusar nome] |\n"
+                            "           --lote arquivo [--silencioso] [--threads n] [--correcoes arquivo]]\n"
+                            "          [--prefixo texto] [--pagina n] [--posicao pista] [--retomar sessao.dqs] [--salvar sessao.dqs]\n"
+                            "       %s --converter entrada.txt saida.dqm\n"
+                            "       %s --gerar-hash entrada.txt associacoes_fixas.h\n",
+                    argv[0], argv[0], argv[0]);
+            return EXIT_FAILURE;
+        }
     }
-    return raiz;
-}
-
-/* hash function djb2 */
-unsigned long hash_djb2(const char *str) {
-    unsigned long hash = 5381;
-    int c;
-    while ((c = (unsigned char)*str++))
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-    return hash % HASH_SIZE;
-}
-
-/* inserirNaHash: adiciona mapeamento pista -> suspeito (encadeamento) */
-void inserirNaHash(HashEntry *hash[], const char *pista, const char *suspeito) {
-    if (!pista || pista[0] == '\0' || !suspeito) return;
-    unsigned long idx = hash_djb2(pista);
-    HashEntry *novo = (HashEntry*) malloc(sizeof(HashEntry));
-    if (!novo) { perror("malloc"); exit(EXIT_FAILURE); }
-    strncpy(novo->pista, pista, MAX_PISTA-1); novo->pista[MAX_PISTA-1] = '\0';
-    strncpy(novo->suspeito, suspeito, MAX_NOME-1); novo->suspeito[MAX_NOME-1] = '\0';
-    novo->proximo = hash[idx];
-    hash[idx] = novo;
-}
-
-/* encontrarSuspeito: retorna ponteiro para nome do suspeito (ou NULL se não existir) */
-const char* encontrarSuspeito(HashEntry *hash[], const char *pista) {
-    if (!pista) return NULL;
-    unsigned long idx = hash_djb2(pista);
-    for (HashEntry *e = hash[idx]; e != NULL; e = e->proximo) {
-        if (strcmp(e->pista, pista) == 0) return e->suspeito;
+    if (dicas && caminhoMapa && paginar) {
+        // o índice de rotas numera todas as salas e interna as pistas: leria o mapa inteiro
+        fprintf(stderr, "--dicas não combina com --paginada: as rotas exigem o mapa inteiro\n");
+        return EXIT_FAILURE;
     }
-    return NULL;
-}
 
-/* explorarSalas: interação do jogador; coleta pistas automaticamente */
-void explorarSalas(Sala *atual, PistaNode **raizPistas, HashEntry *hash[]) {
-    char opcao;
-    while (atual != NULL) {
-        printf("\nVocê está em: %s\n", atual->nome);
-
-        if (strlen(atual->pista) > 0) {
-            printf("🔎 Pista encontrada: \"%s\"\n", atual->pista);
-            // Adiciona à BST de pistas
-            *raizPistas = inserirPista(*raizPistas, atual->pista);
-        } else {
-            printf("Nenhuma pista neste cômodo.\n");
+    /* --- Arenas: a do mapa vive o programa todo; a da sessão é descartada de uma vez --- */
+    Arena arenaMapa = { NULL, NULL }, arenaSessao = { NULL, NULL };
+    usarArena(&arenaMapa);
+
+    TabelaHash hash;
+    inicializarHash(&hash);
+    Processo processo;
+    iniciarProcesso(&processo);
+    Processo *comProcesso = ponderado ? &processo : NULL;
+
+    /* --- Mansão: fixa no código (ponteiros ou plana) ou mapeada do arquivo binário --- */
+    Mansao mansao = { NULL, NULL, NULL };
+    MapaBinario mapa;
+    MansaoPlana plana;
+    MansaoPaginada paginada;
+    memset(&mapa, 0, sizeof(mapa));
+    memset(&plana, 0, sizeof(plana));
+    memset(&paginada, 0, sizeof(paginada));
+    if (caminhoMapa && paginar) {
+        if (abrirMansaoPaginada(caminhoMapa, cacheSalas, &hash, comProcesso, &paginada) != 0) {
+            usarArena(NULL);
+            arenaLiberar(&arenaMapa);
+            liberarProcesso(&processo);
+            liberarTextos();
+            return EXIT_FAILURE;
         }
-
-        // Menu de navegação
-        printf("\nEscolha o caminho:\n");
-        if (atual->esquerda) printf("(e) Esquerda -> %s\n", atual->esquerda->nome);
-        if (atual->direita) printf("(d) Direita  -> %s\n", atual->direita->nome);
-        printf("(s) Sair e apresentar as pistas coletadas\n> ");
-        if (scanf(" %c", &opcao) != 1) { while (getchar() != '\n'); opcao = 's'; }
-
-        if (opcao == 'e' || opcao == 'E') {
-            if (atual->esquerda) atual = atual->esquerda;
-            else printf("⚠️  Caminho inexistente à esquerda!\n");
-        } else if (opcao == 'd' || opcao == 'D') {
-            if (atual->direita) atual = atual->direita;
-            else printf("⚠️  Caminho inexistente à direita!\n");
-        } else if (opcao == 's' || opcao == 'S') {
-            printf("\nVocê decidiu encerrar a exploração.\n");
-            return;
-        } else {
-            printf("Opção inválida. Use 'e', 'd' ou 's'.\n");
+        mansao.paginada = &paginada;
+        if (threads != 1) {
+            fprintf(stderr, "--paginada: o lote roda numa thread (o cache de salas é do processo)\n");
+            threads = 1;
         }
-    }
-}
-
-/* exibirPistas: percorre BST em ordem e imprime pista + ocorrencias */
-void exibirPistas(PistaNode *raiz) {
-    if (raiz == NULL) return;
-    exibirPistas(raiz->esquerda);
-    printf(" - \"%s\" (x%d)\n", raiz->pista, raiz->ocorrencias);
-    exibirPistas(raiz->direita);
-}
-
-/* verificarSuspeitoFinal: percorre BST, usa hash para contar pistas que apontam para 'acusado' */
-int verificarSuspeitoFinal(PistaNode *raiz, HashEntry *hash[], const char *acusado) {
-    if (!raiz) return 0;
-    int total = 0;
-    // in-order traversal with accumulation
-    if (raiz->esquerda) total += verificarSuspeitoFinal(raiz->esquerda, hash, acusado);
-    const char *sus = encontrarSuspeito(hash, raiz->pista);
-    if (sus && strcmp(sus, acusado) == 0) total += raiz->ocorrencias;
-    if (raiz->direita) total += verificarSuspeitoFinal(raiz->direita, hash, acusado);
-    return total;
-}
-
-/* liberarSalas: libera árvore da mansão */
-void liberarSalas(Sala *raiz) {
-    if (!raiz) return;
-    liberarSalas(raiz->esquerda);
-    liberarSalas(raiz->direita);
-    free(raiz);
-}
-
-/* liberarPistas: libera BST de pistas */
-void liberarPistas(PistaNode *raiz) {
-    if (!raiz) return;
-    liberarPistas(raiz->esquerda);
-    liberarPistas(raiz->direita);
-    free(raiz);
-}
-
-/* liberarHash: libera todos os buckets da tabela hash */
-void liberarHash(HashEntry *hash[]) {
-    for (int i = 0; i < HASH_SIZE; i++) {
-        HashEntry *e = hash[i];
-        while (e) {
-            HashEntry *t = e->proximo;
-            free(e);
-            e = t;
+    } else if (caminhoMapa) {
+        if (carregarMapa(caminhoMapa, &mapa, &hash, comProcesso) != 0) {
+            usarArena(NULL);
+            arenaLiberar(&arenaMapa);
+            liberarProcesso(&processo);
+            liberarTextos();
+            return EXIT_FAILURE;
         }
-        hash[i] = NULL;
-    }
-}
-
-/* strip newline de fgets */
-void strip_newline(char *s) {
-    size_t L = strlen(s);
-    if (L == 0) return;
-    if (s[L-1] == '\n') s[L-1] = '\0';
-}
-
-/* ------------------ Programa principal ------------------ */
-int main() {
-    /* --- Montagem fixa da mansão (árvore binária) --- */
-    Sala *hall = criarSala("Hall de Entrada", "Pegada de lama");
-    Sala *salaEstar = criarSala("Sala de Estar", "Lenço rasgado");
-    Sala *cozinha = criarSala("Cozinha", "Copo quebrado");
-    Sala *biblioteca = criarSala("Biblioteca", "Diário antigo");
-    Sala *jardim = criarSala("Jardim", "Chave enferrujada");
-    Sala *despensa = criarSala("Despensa", "Luvas sujas");
-    Sala *garagem = criarSala("Garagem", "Pneu com marca estranha");
-    Sala *porao = criarSala("Porão", "Marca de tinta vermelha");
-
-    // ligações
-    hall->esquerda = salaEstar; hall->direita = cozinha;
-    salaEstar->esquerda = biblioteca; salaEstar->direita = jardim;
-    cozinha->esquerda = despensa; cozinha->direita = garagem;
-    biblioteca->esquerda = porao; // exemplo de profundidade extra
-
-    /* --- Inicializa BST de pistas e tabela hash --- */
-    PistaNode *raizPistas = NULL;
-    HashEntry *hash[HASH_SIZE];
-    for (int i = 0; i < HASH_SIZE; i++) hash[i] = NULL;
-
-    /* --- Popula a tabela hash com associação pista -> suspeito --- */
-    // (As associações são fixas no código)
-    inserirNaHash(hash, "Pegada de lama", "Sr. Verdes");
-    inserirNaHash(hash, "Lenço rasgado", "Sra. Marinho");
-    inserirNaHash(hash, "Copo quebrado", "Sra. Marinho");
-    inserirNaHash(hash, "Diário antigo", "Sr. Rocha");
-    inserirNaHash(hash, "Chave enferrujada", "Sr. Verdes");
-    inserirNaHash(hash, "Luvas sujas", "Sr. Rocha");
-    inserirNaHash(hash, "Pneu com marca estranha", "Motorista");
-    inserirNaHash(hash, "Marca de tinta vermelha", "Pintor");
-
-    /* --- Início da exploração --- */
-    printf("🕵️ Detective Quest — Investigue a mansão e colete pistas!\n");
-    printf("Navegue com (e) esquerda, (d) direita ou (s) sair e acusar.\n");
-    explorarSalas(hall, &raizPistas, hash);
-
-    /* --- Fase final: exibir pistas coletadas e acusação --- */
-    printf("\n📜 Pistas coletadas (ordenadas):\n");
-    if (!raizPistas) {
-        printf("Nenhuma pista coletada.\n");
+        mansao.plana = &mapa.mansao;
     } else {
-        exibirPistas(raizPistas);
+        mansao.raizArvore = montarMansaoFixa(&hash, comProcesso);
+        if (usarPlana) {
+            planificarMansao(mansao.raizArvore, ordemPlana, &plana);
+            mansao.raizArvore = NULL; // os nós continuam na arena do mapa
+            mansao.plana = &plana;
+        }
     }
+    // filtro de Bloom só com muitas associações: com a tabela no cache, a consulta ao filtro
+    // custa tanto quanto a sondagem e os acertos pagam as duas (a paginada conta as do mapa)
+    if ((mansao.paginada ? paginada.cab.totalAssociacoes : hash.tamanho) >= FILTRO_ENTRADAS_MINIMAS)
+        ativarFiltro(&hash);
+    MapaRotas rotas;
+    memset(&rotas, 0, sizeof(rotas));
+    if (dicas) construirRotas(&mansao, &rotas);
+    if (ponderado) compilarProcesso(&processo);
+    if (mostrarInfo && mansao.paginada)   // a profundidade exigiria ler o mapa inteiro
+        printf("Mansão (mapa paginado): %u salas, até %u residentes, %zu bytes de cache\n",
+               contarSalas(&mansao), paginada.capacidade, memoriaMansao(&mansao));
+    else if (mostrarInfo)
+        printf("Mansão (%s): %u salas, profundidade %u, %zu bytes de navegação\n",
+               mansao.plana ? "layout plano" : "árvore de ponteiros",
+               contarSalas(&mansao), profundidadeMansao(&mansao), memoriaMansao(&mansao));
+    if (mostrarInfo && dicas)
+        printf("Rotas: %u salas indexadas, %zu bytes\n", rotas.total,
+               (size_t) rotas.total * (sizeof(PosicaoSala) + 5 * sizeof(uint32_t)) +
+               (size_t) rotas.niveis * rotas.blocos * sizeof(uint32_t));
+    if (mostrarInfo && ponderado)
+        printf("Processo: %zu implicações, %u pistas x %u suspeitos, %u plano(s) de peso, %zu bytes de bitsets\n",
+               processo.totalImplicacoes, processo.totalPistas, processo.totalSuspeitos, processo.planos,
+               (size_t) processo.totalSuspeitos * (1 + processo.planos) * processo.palavras * sizeof(uint64_t));
+
+    int status = EXIT_SUCCESS;
+    TabelaConcorrente concorrente;
+    Correcoes correcoes;
+    int corrigindo = 0;
+    if (caminhoLote && caminhoCorrecoes) {
+        // a tabela passa a aceitar escritas com as sessões lendo
+        iniciarConcorrente(&concorrente);
+        tornarHashConcorrente(&hash, &concorrente);
+        if (iniciarCorrecoes(caminhoCorrecoes, &concorrente, &correcoes) == 0) corrigindo = 1;
+        else status = EXIT_FAILURE;
+    }
+    if (caminhoLote && status == EXIT_SUCCESS) {
+        /* --- Reprodução em lote: sem interação, mapa compartilhado entre as threads --- */
+        if (executarLote(caminhoLote, &mansao, &hash, dicas ? &rotas : NULL, comProcesso, historico,
+                         silencioso, threads) != 0) status = EXIT_FAILURE;
+        if (corrigindo) concluirCorrecoes(&correcoes);
+#ifdef DETECTIVE_ESTATISTICAS
+        relatarEstatisticas(stderr, &mansao, &hash, NULL);
+#endif
+    } else if (!caminhoLote) {
+        /* --- Sessão única: interativa ou roteirizada (--roteiro) --- */
+        usarArena(&arenaSessao);
+        Sessao sessao;
+        iniciarSessao(&sessao);
+        if (dicas) sessao.rotas = &rotas;
+        sessao.processo = comProcesso;
+        sessao.gravarEm = caminhoSalvar;
+        Saida saida = { NULL, 0, 0, silencioso };
+        if (roteiro) {
+            sessao.roteiro = roteiro;
+            sessao.saida = &saida;
+        }
 
-    char acusado[MAX_NOME];
-    printf("\nQuem você acusa? (digite o nome exato do suspeito):\n> ");
-    // Consome newline pendente e lê linha
-    getchar(); // consome '\n' restante do último scanf
-    if (!fgets(acusado, sizeof(acusado), stdin)) acusado[0] = '\0';
-    strip_newline(acusado);
-
-    if (strlen(acusado) == 0) {
-        printf("Nenhum acusado informado. Encerrando sem julgamento.\n");
-    } else {
-        int total = verificarSuspeitoFinal(raizPistas, hash, acusado);
-        printf("\nResultado da acusação contra \"%s\":\n", acusado);
-        if (total >= 2) {
-            printf("✅ Há %d pistas que apontam para %s. Acusação sustentada!\n", total, acusado);
-        } else if (total == 1) {
-            printf("⚠️ Apenas 1 pista aponta para %s. Provas insuficientes para condenar.\n", acusado);
+        if (caminhoRetomar && retomarSessao(caminhoRetomar, &mansao, &sessao) != 0) {
+            status = EXIT_FAILURE;
         } else {
-            printf("❌ Nenhuma pista coletada aponta para %s. Acusação infundada.\n", acusado);
+            if (historico) ativarHistorico(&sessao);
+            emitir(sessao.saida, "🕵️ Detective Quest — Investigue a mansão e colete pistas!\n");
+            emitir(sessao.saida, "Navegue com (e) esquerda, (d) direita ou (s) sair e acusar.\n");
+            if (dicas) emitir(sessao.saida, "Dicas ativas: (v) volta uma sala e (r) mostra a rota até a pista nova mais próxima.\n");
+            if (historico) emitir(sessao.saida, "Histórico ativo: (u) desfaz o último passo, (b) guarda uma bifurcação e (a) volta a ela.\n");
+            if (caminhoSalvar) emitir(sessao.saida, "Gravação ativa: (g) grava a sessão em %s e para (continue com --retomar).\n", caminhoSalvar);
+            if (caminhoRetomar) emitir(sessao.saida, "(sessão retomada de %s)\n", caminhoRetomar);
+            explorarSalas(&mansao, &sessao, &hash);
+
+            if (!sessao.suspensa) {   // suspensa em (g): a fase final fica para quem retomar
+                /* --- Fase final: exibir pistas coletadas e acusação --- */
+                apresentarPistas(&sessao);
+                apresentarRanking(&sessao, RANKING_EXIBIDO);
+                apresentarPonderado(&sessao, RANKING_EXIBIDO);
+                if (prefixo) apresentarPrefixo(&sessao, prefixo);
+                if (pagina) apresentarPagina(&sessao, pagina);
+                if (posicao) apresentarPosicao(&sessao, posicao);
+
+                char acusado[MAX_NOME];
+                if (roteiro) {
+                    snprintf(acusado, sizeof(acusado), "%s", acusadoRoteiro ? acusadoRoteiro : "");
+                } else {
+                    printf("\nQuem você acusa? (digite o nome exato do suspeito):\n> ");
+                    // Consome newline pendente e lê linha
+                    getchar(); // consome '\n' restante do último scanf
+                    if (!fgets(acusado, sizeof(acusado), stdin)) acusado[0] = '\0';
+                    strip_newline(acusado);
+                }
+                julgarAcusacao(&sessao, acusado);
+                if (caminhoSalvar) {
+                    if (salvarSessao(caminhoSalvar, &mansao, &sessao) == 0)
+                        emitir(sessao.saida, "💾 Sessão salva em %s\n", caminhoSalvar);
+                    else
+                        status = EXIT_FAILURE;
+                }
+            }
+            emitir(sessao.saida, "\nObrigado por jogar Detective Quest — Capítulo Final.\n");
+            if (saida.tam) fwrite(saida.buf, 1, saida.tam, stdout);
+            free(saida.buf);
+#ifdef DETECTIVE_ESTATISTICAS
+            relatarEstatisticas(stderr, &mansao, &hash, &sessao);
+#endif
         }
-    }
 
-    /* --- Limpeza de memória --- */
-    liberarSalas(hall);
-    liberarPistas(raizPistas);
-    liberarHash(hash);
+        /* --- Limpeza de memória: um único descarte da arena --- */
+        // (sem arena, usar liberarSalas/liberarPistas/liberarHash)
+        liberarSessao(&sessao);
+    }
 
-    printf("\nObrigado por jogar Detective Quest — Capítulo Final.\n");
-    return 0;
+    if (hash.concorrente) {
+        liberarLeitorConcorrente();
+        liberarConcorrente(&concorrente);
+    }
+    fecharMapa(&mapa);
+    liberarRotas(&rotas);
+    liberarProcesso(&processo);
+    fecharMansaoPaginada(&paginada);
+    liberarMansaoPlana(&plana);
+    usarArena(NULL);
+    arenaLiberar(&arenaSessao);
+    arenaLiberar(&arenaMapa);
+    liberarTextos();
+    return status;
 }
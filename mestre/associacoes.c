@@ -0,0 +1,119 @@
+/* associacoes.c – associações pista -> suspeito: tabela dinâmica (ou concorrente) e hash
+   perfeito gerado */
+
+#include "associacoes.h"
+#include "concorrente.h"
+#include "hash.h"
+#include "textos.h"
+
+#ifdef COM_ASSOCIACOES_FIXAS
+/* slot -> ids da associação fixa, resolvidos em usarAssociacoesFixas() (valem até liberarTextos) */
+static HashEntry entradasFixas[TOTAL_ASSOCIACOES_FIXAS];
+static int fixasResolvidas = 0;
+#endif
+
+/* inserirNaHashId: adiciona (ou substitui) o mapeamento pista -> suspeito */
+void inserirNaHashId(TabelaHash *hash, IdTexto pista, IdTexto suspeito) {
+    if (pista == SEM_TEXTO || suspeito == SEM_TEXTO) return;
+    if (hash->concorrente) {
+        inserirConcorrente(hash->concorrente, pista, suspeito);
+        return;
+    }
+    unsigned long h = hashId(pista);
+    long i = buscarSlot(hash, h, pista, NULL);
+    if (i >= 0) {
+        hash->entradas[i].suspeito = suspeito;
+        return;
+    }
+    HashEntry novo = { pista, suspeito };
+    inserirSlot(hash, h, novo);
+    if (hash->filtro.palavras) marcarFiltro(&hash->filtro, h);
+}
+
+/* inserirNaHash: interna os textos e registra a associação */
+void inserirNaHash(TabelaHash *hash, const char *pista, const char *suspeito) {
+    if (!pista || pista[0] == '\0' || !suspeito) return;
+    inserirNaHashId(hash, internar(pista), internar(suspeito));
+}
+
+/* grupoPerfeito / slotPerfeito: os bits altos do hash escolhem o grupo; o deslocamento do
+   grupo, misturado ao hash, escolhe o slot. Redução por multiplicação, sem divisão. */
+uint32_t grupoPerfeito(uint64_t h, uint32_t grupos) {
+    return (uint32_t) (((h >> 32) * grupos) >> 32);
+}
+
+uint32_t slotPerfeito(uint64_t h, uint32_t deslocamento, uint32_t total) {
+    return (uint32_t) (((misturar64(h ^ deslocamento) & 0xFFFFFFFFu) * total) >> 32);
+}
+
+#ifdef COM_ASSOCIACOES_FIXAS
+/* buscarAssociacaoFixa: um slot calculado e uma comparação de ids; sem colisões a resolver */
+static IdTexto buscarAssociacaoFixa(IdTexto pista) {
+    if (pista >= textosGlobais.total) return SEM_TEXTO;
+    uint64_t h = hashDoTexto(pista);
+    uint32_t slot = slotPerfeito(h, DESLOCAMENTOS_FIXOS[grupoPerfeito(h, GRUPOS_ASSOCIACOES_FIXAS)],
+                                 TOTAL_ASSOCIACOES_FIXAS);
+    ESTAT_CONSULTA(1);
+    return entradasFixas[slot].pista == pista ? entradasFixas[slot].suspeito : SEM_TEXTO;
+}
+#endif
+
+int usarAssociacoesFixas(TabelaHash *hash) {
+#ifdef COM_ASSOCIACOES_FIXAS
+    if (!fixasResolvidas) {
+        for (uint32_t i = 0; i < TOTAL_ASSOCIACOES_FIXAS; i++) {
+            if (hashChave(ASSOCIACOES_FIXAS[i].pista) != ASSOCIACOES_FIXAS[i].hash) {
+                // gerado com outra função de hash: as posições não valem mais
+                fprintf(stderr, "associacoes_fixas.h desatualizado; regenere com --gerar-hash\n");
+                for (uint32_t j = 0; j < TOTAL_ASSOCIACOES_FIXAS; j++)
+                    inserirNaHash(hash, ASSOCIACOES_FIXAS[j].pista, ASSOCIACOES_FIXAS[j].suspeito);
+                return 0;
+            }
+        }
+        for (uint32_t i = 0; i < TOTAL_ASSOCIACOES_FIXAS; i++) {
+            entradasFixas[i].pista = internar(ASSOCIACOES_FIXAS[i].pista);
+            entradasFixas[i].suspeito = internar(ASSOCIACOES_FIXAS[i].suspeito);
+        }
+        fixasResolvidas = 1;
+    }
+    hash->fixas = 1;
+    return 0;
+#else
+    (void) hash;
+    return -1;
+#endif
+}
+
+void esquecerAssociacoesFixas(void) {
+#ifdef COM_ASSOCIACOES_FIXAS
+    fixasResolvidas = 0;
+#endif
+}
+
+/* encontrarSuspeitoId: suspeito da pista (SEM_TEXTO se não houver associação).
+   A parte dinâmica vem primeiro: uma associação inserida em tempo de execução prevalece. */
+IdTexto encontrarSuspeitoId(const TabelaHash *hash, IdTexto pista) {
+    if (pista == SEM_TEXTO) return SEM_TEXTO;
+    if (hash->concorrente) {
+        IdTexto sus = buscarConcorrente(hash->concorrente, pista);
+        if (sus != SEM_TEXTO) return sus;
+    } else if (hash->tamanho) {
+        // sem filtro, ou aprovada por ele: só então a sondagem
+        unsigned long h = hashId(pista);
+        if (!hash->filtro.palavras || passaNoFiltro(&hash->filtro, h)) {
+            long i = buscarSlot(hash, h, pista, NULL);
+            if (i >= 0) return hash->entradas[i].suspeito;
+            if (hash->filtro.palavras) ESTAT_FILTRO(filtroFalsos);
+        }
+    }
+#ifdef COM_ASSOCIACOES_FIXAS
+    if (hash->fixas) return buscarAssociacaoFixa(pista);
+#endif
+    return SEM_TEXTO;
+}
+
+/* encontrarSuspeito: retorna ponteiro para nome do suspeito (ou NULL se não existir) */
+const char* encontrarSuspeito(const TabelaHash *hash, const char *pista) {
+    IdTexto sus = encontrarSuspeitoId(hash, buscarTexto(pista));
+    return sus != SEM_TEXTO ? textoDe(sus) : NULL;
+}
@@ -0,0 +1,56 @@
+/* associacoes.h – associações pista -> suspeito */
+#ifndef MESTRE_ASSOCIACOES_H
+#define MESTRE_ASSOCIACOES_H
+
+#include "tabela.h"
+
+/* Associação estática gerada por --gerar-hash: a posição no vetor é o slot do hash
+   perfeito mínimo e 'hash' é o hashChave da pista (conferido antes de usar a tabela) */
+typedef struct AssociacaoFixa {
+    uint64_t hash;
+    const char *pista;
+    const char *suspeito;
+} AssociacaoFixa;
+
+/* Implicação do processo gerada por --gerar-hash (as linhas "implica", na ordem do arquivo) */
+typedef struct ImplicacaoFixa {
+    const char *pista;
+    const char *suspeito;
+    uint32_t peso;
+} ImplicacaoFixa;
+
+/* sem o arquivo gerado (na raiz do projeto), a mansão fixa volta a popular a tabela dinâmica */
+#if defined(__has_include)
+#if __has_include("../associacoes_fixas.h")
+#include "../associacoes_fixas.h"
+#define COM_ASSOCIACOES_FIXAS 1
+#endif
+#endif
+
+/* usarAssociacoesFixas() – liga a tabela ao hash perfeito de associacoes_fixas.h: cada
+   consulta custa um cálculo de slot e uma comparação, sem alocar a tabela (só os textos
+   são internados, uma vez por processo, antes das threads). Associações
+   inseridas depois continuam na parte dinâmica e têm precedência. Retorna -1 se o
+   programa foi compilado sem o arquivo gerado. */
+int usarAssociacoesFixas(TabelaHash *hash);
+
+/* esquecerAssociacoesFixas() – descarta os ids resolvidos das associações fixas (que valem
+   até liberarTextos); a próxima usarAssociacoesFixas() os interna de novo. */
+void esquecerAssociacoesFixas(void);
+
+/* grupoPerfeito() / slotPerfeito() – grupo da chave e slot dela dado o deslocamento do
+   grupo: a mesma conta no gerador (gerarHashPerfeito) e na consulta. */
+uint32_t grupoPerfeito(uint64_t h, uint32_t grupos);
+uint32_t slotPerfeito(uint64_t h, uint32_t deslocamento, uint32_t total);
+
+/* inserirNaHash() – insere associação pista/suspeito na tabela hash.
+   Se a pista já existe, o suspeito é substituído. */
+void inserirNaHash(TabelaHash *hash, const char *pista, const char *suspeito);
+void inserirNaHashId(TabelaHash *hash, IdTexto pista, IdTexto suspeito);
+
+/* encontrarSuspeito() – consulta o suspeito correspondente a uma pista.
+   A versão por id é a usada no caminho quente (sem strcmp). */
+const char* encontrarSuspeito(const TabelaHash *hash, const char *pista);
+IdTexto encontrarSuspeitoId(const TabelaHash *hash, IdTexto pista);
+
+#endif
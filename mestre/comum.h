@@ -0,0 +1,85 @@
+/* comum.h – constantes, ids de texto e estatísticas compartilhados por todos os módulos */
+#ifndef MESTRE_COMUM_H
+#define MESTRE_COMUM_H
+
+/* strnlen e pread são POSIX: com -std=c11 os cabeçalhos só os declaram se pedidos */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define FAIXAS_LATENCIA 32           // histograma de latência em potências de 2 de ns
+#define FAIXAS_SONDAGEM 16           // histograma de sondagens (a última faixa acumula o resto)
+
+/* Estatísticas: sem DETECTIVE_ESTATISTICAS as macros ESTAT_* não geram código */
+#ifdef DETECTIVE_ESTATISTICAS
+#define ESTAT_ALOCACAO(estrutura, n) \
+    atomic_fetch_add_explicit(&estatisticas.alocacoes[estrutura], (n), memory_order_relaxed)
+#define ESTAT_CONSULTA(sondagens) registrarConsulta(sondagens)
+#define ESTAT_FILTRO(campo) atomic_fetch_add_explicit(&estatisticas.campo, 1, memory_order_relaxed)
+#define ESTAT_INICIO(var) uint64_t var = relogioNs()
+#define ESTAT_PASSO(inicio) registrarPasso(relogioNs() - (inicio))
+#else
+#define ESTAT_ALOCACAO(estrutura, n) ((void) (estrutura))
+#define ESTAT_CONSULTA(sondagens) ((void) 0)
+#define ESTAT_FILTRO(campo) ((void) 0)
+#define ESTAT_INICIO(var) ((void) 0)
+#define ESTAT_PASSO(inicio) ((void) 0)
+#endif
+
+/* Identificador de um texto internado (pista, suspeito ou nome de sala) */
+typedef uint32_t IdTexto;
+#define SEM_TEXTO 0   // id reservado: "nenhum texto"
+
+/* Estruturas cujas chamadas a malloc/realloc as estatísticas contam em separado */
+typedef enum {
+    ALOC_ARENA, ALOC_SALAS, ALOC_PISTAS, ALOC_HASH, ALOC_TEXTOS, ALOC_SESSAO,
+    ALOC_SAIDA, ALOC_MANSAO, ALOC_LOTE, ALOC_MAPA, ALOC_TRIE, ALOC_ROTAS, ALOC_PROCESSO,
+    TOTAL_ALOCACOES
+} EstruturaAlocada;
+
+#ifdef DETECTIVE_ESTATISTICAS
+/* Contadores do motor. Atômicos (relaxados) porque as threads do lote também somam;
+   ocupação das tabelas e formato das árvores são medidos só na hora do relatório. */
+typedef struct Estatisticas {
+    atomic_ulong alocacoes[TOTAL_ALOCACOES];
+    atomic_ulong consultas;                           // buscas nas tabelas hash
+    atomic_ulong sondagens;                           // slots examinados nessas buscas
+    atomic_ulong sondagensPorConsulta[FAIXAS_SONDAGEM];
+    atomic_ulong passos;                              // salas processadas em explorarSalas
+    atomic_ulong nsPassos;
+    atomic_ulong latencia[FAIXAS_LATENCIA];           // faixa k: passos de [2^k, 2^(k+1)) ns
+    atomic_ulong filtroConsultas;                     // pistas testadas no filtro de Bloom
+    atomic_ulong filtroRejeitadas;                    // descartadas sem tocar na tabela
+    atomic_ulong filtroFalsos;                        // aprovadas pelo filtro e ausentes da tabela
+} Estatisticas;
+#endif
+
+#ifdef DETECTIVE_ESTATISTICAS
+extern Estatisticas estatisticas;
+
+/* relogioNs() – relógio monotônico em ns. registrarConsulta() / registrarPasso() – somam
+   uma busca numa tabela (com as sondagens) e um passo da exploração (com a latência). */
+uint64_t relogioNs(void);
+void registrarConsulta(size_t sondagens);
+void registrarPasso(uint64_t ns);
+#endif
+
+#endif
@@ -0,0 +1,189 @@
+/* concorrente.c – tabela pista -> suspeito concorrente: leituras sem trava, versões antigas
+   liberadas por épocas */
+
+#include "concorrente.h"
+#include "hash.h"
+
+/* Leitor do domínio de épocas: a época global vista no início da consulta em andamento
+   (0 = fora de consulta). Uma linha de cache por leitor, sem falso compartilhamento. */
+typedef struct LeitorEpoca {
+    _Alignas(64) atomic_uint_fast64_t epoca;
+    atomic_int ocupado;
+} LeitorEpoca;
+
+/* Domínio de épocas compartilhado pelas tabelas concorrentes. Uma versão aposentada na
+   época r pode ser liberada quando todo leitor em consulta anunciou época > r: quem
+   anunciou depois do incremento já carrega a versão nova. */
+static atomic_uint_fast64_t epocaGlobal = 1;
+static LeitorEpoca leitoresEpoca[LEITORES_MAX];
+static _Thread_local int slotLeitor = -1;
+
+/* leitorDaThread: slot de leitor da thread, ocupado na primeira consulta */
+static LeitorEpoca* leitorDaThread(void) {
+    if (slotLeitor < 0) {
+        for (int i = 0; i < LEITORES_MAX && slotLeitor < 0; i++) {
+            int livre = 0;
+            if (atomic_compare_exchange_strong(&leitoresEpoca[i].ocupado, &livre, 1)) slotLeitor = i;
+        }
+        if (slotLeitor < 0) {
+            fprintf(stderr, "tabela concorrente: mais de %d threads leitoras\n", LEITORES_MAX);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return &leitoresEpoca[slotLeitor];
+}
+
+void liberarLeitorConcorrente(void) {
+    if (slotLeitor < 0) return;
+    atomic_store_explicit(&leitoresEpoca[slotLeitor].epoca, 0, memory_order_relaxed);
+    atomic_store_explicit(&leitoresEpoca[slotLeitor].ocupado, 0, memory_order_release);
+    slotLeitor = -1;
+}
+
+/* novaVersao: cabeçalho, slots e filtro (alinhado a 64 bytes) numa alocação só */
+static VersaoConcorrente* novaVersao(size_t capacidade) {
+    size_t blocos = blocosDoFiltro(capacidade);
+    size_t offFiltro = (sizeof(VersaoConcorrente) + capacidade * sizeof(uint64_t) + 63) & ~(size_t) 63;
+    ESTAT_ALOCACAO(ALOC_HASH, 1);
+    VersaoConcorrente *v = (VersaoConcorrente*) aligned_alloc(64, offFiltro + blocos * 8 * sizeof(uint64_t));
+    if (!v) { perror("aligned_alloc"); exit(EXIT_FAILURE); }
+    v->capacidade = capacidade;
+    v->epoca = 0;
+    v->proxima = NULL;
+    v->filtro.palavras = (_Atomic uint64_t*) ((unsigned char*) v + offFiltro);
+    v->filtro.blocos = blocos;
+    for (size_t i = 0; i < capacidade; i++) atomic_init(&v->slots[i], 0);
+    for (size_t i = 0; i < blocos * 8; i++) atomic_init(&v->filtro.palavras[i], 0);
+    return v;
+}
+
+/* slotDaPista: slot que guarda a pista ou o vazio onde ela entraria; *sondagens conta os examinados */
+static size_t slotDaPista(const VersaoConcorrente *v, IdTexto pista, unsigned long h,
+                          uint64_t *entrada, size_t *sondagens) {
+    size_t mascara = v->capacidade - 1, i = h & mascara, n = 1;
+    uint64_t e;
+    while ((e = atomic_load_explicit(&v->slots[i], memory_order_acquire)) != 0 && (IdTexto) (e >> 32) != pista) {
+        i = (i + 1) & mascara;
+        n++;
+    }
+    *entrada = e;
+    *sondagens = n;
+    return i;
+}
+
+void iniciarConcorrente(TabelaConcorrente *tc) {
+    atomic_init(&tc->atual, novaVersao(HASH_CAPACIDADE_INICIAL));
+    pthread_mutex_init(&tc->escrita, NULL);
+    tc->tamanho = 0;
+    tc->aposentadas = NULL;
+    tc->substituicoes = tc->crescimentos = tc->recuperadas = 0;
+}
+
+void liberarConcorrente(TabelaConcorrente *tc) {
+    free(atomic_load_explicit(&tc->atual, memory_order_relaxed));
+    while (tc->aposentadas) {
+        VersaoConcorrente *v = tc->aposentadas;
+        tc->aposentadas = v->proxima;
+        free(v);
+    }
+    pthread_mutex_destroy(&tc->escrita);
+    atomic_store_explicit(&tc->atual, NULL, memory_order_relaxed);
+}
+
+/* recuperarVersoes: libera as aposentadas antes da menor época anunciada (com 'escrita') */
+static void recuperarVersoes(TabelaConcorrente *tc) {
+    // troca de versão, época e anúncios em seq_cst: ou o leitor anunciou antes (e é visto
+    // aqui) ou ele lê a versão nova
+    uint64_t minima = UINT64_MAX;
+    for (int i = 0; i < LEITORES_MAX; i++) {
+        uint64_t e = atomic_load(&leitoresEpoca[i].epoca);
+        if (e != 0 && e < minima) minima = e;
+    }
+    VersaoConcorrente **ligacao = &tc->aposentadas;
+    while (*ligacao) {
+        VersaoConcorrente *v = *ligacao;
+        if (v->epoca < minima) {
+            *ligacao = v->proxima;
+            free(v);
+            tc->recuperadas++;
+        } else {
+            ligacao = &v->proxima;
+        }
+    }
+}
+
+/* crescerConcorrente: copia para o dobro da capacidade, publica e aposenta a antiga */
+static VersaoConcorrente* crescerConcorrente(TabelaConcorrente *tc, VersaoConcorrente *antiga) {
+    VersaoConcorrente *nova = novaVersao(antiga->capacidade * 2);
+    for (size_t i = 0; i < antiga->capacidade; i++) {
+        uint64_t e = atomic_load_explicit(&antiga->slots[i], memory_order_relaxed), existente;
+        size_t sondagens;
+        if (e == 0) continue;
+        unsigned long h = hashId((IdTexto) (e >> 32));
+        marcarFiltro(&nova->filtro, h);
+        atomic_store_explicit(&nova->slots[slotDaPista(nova, (IdTexto) (e >> 32), h, &existente, &sondagens)],
+                              e, memory_order_relaxed);
+    }
+    atomic_store(&tc->atual, nova);
+    antiga->epoca = atomic_fetch_add(&epocaGlobal, 1);
+    antiga->proxima = tc->aposentadas;
+    tc->aposentadas = antiga;
+    tc->crescimentos++;
+    recuperarVersoes(tc);
+    return nova;
+}
+
+/* inserirConcorrente: o par inteiro numa escrita de 64 bits; leitores veem o antigo ou o novo */
+void inserirConcorrente(TabelaConcorrente *tc, IdTexto pista, IdTexto suspeito) {
+    if (pista == SEM_TEXTO || suspeito == SEM_TEXTO) return;
+    uint64_t par = (uint64_t) pista << 32 | suspeito, existente;
+    unsigned long h = hashId(pista);
+    size_t sondagens;
+    pthread_mutex_lock(&tc->escrita);
+    VersaoConcorrente *v = atomic_load_explicit(&tc->atual, memory_order_relaxed);
+    size_t i = slotDaPista(v, pista, h, &existente, &sondagens);
+    if (existente != 0) {
+        tc->substituicoes++;
+    } else {
+        if ((tc->tamanho + 1) * HASH_CARGA_DEN > v->capacidade * HASH_CARGA_NUM) {
+            v = crescerConcorrente(tc, v);
+            i = slotDaPista(v, pista, h, &existente, &sondagens);
+        }
+        marcarFiltro(&v->filtro, h);   // antes do par: quem vê o par também vê os bits
+        tc->tamanho++;
+    }
+    atomic_store_explicit(&v->slots[i], par, memory_order_release);
+    pthread_mutex_unlock(&tc->escrita);
+}
+
+/* buscarConcorrente: anuncia a época, sonda a versão atual e sai do anúncio */
+IdTexto buscarConcorrente(const TabelaConcorrente *tc, IdTexto pista) {
+    LeitorEpoca *leitor = leitorDaThread();
+    // acquire: quem lê a época já incrementada vê também a troca de versão feita antes dela;
+    // com relaxed, anunciaria r + 1 e ainda poderia carregar a versão aposentada na época r
+    atomic_store(&leitor->epoca, atomic_load_explicit(&epocaGlobal, memory_order_acquire));
+    const VersaoConcorrente *v = atomic_load(&tc->atual);   // seq_cst: depois do anúncio
+    unsigned long h = hashId(pista);
+    uint64_t e = 0;
+    if (passaNoFiltro(&v->filtro, h)) {
+        size_t sondagens;
+        slotDaPista(v, pista, h, &e, &sondagens);
+        ESTAT_CONSULTA(sondagens);
+        if (e == 0) ESTAT_FILTRO(filtroFalsos);
+    }
+    atomic_store_explicit(&leitor->epoca, 0, memory_order_release);
+    return e != 0 ? (IdTexto) (e & 0xFFFFFFFFu) : SEM_TEXTO;
+}
+
+/* tornarHashConcorrente: as associações dinâmicas passam para 'tc' (antes das threads) */
+void tornarHashConcorrente(TabelaHash *hash, TabelaConcorrente *tc) {
+    for (size_t i = 0; i < hash->capacidade; i++)
+        if (hash->hashes[i] != 0) inserirConcorrente(tc, hash->entradas[i].pista, hash->entradas[i].suspeito);
+    Arena *arena = hash->arena;
+    int fixas = hash->fixas;
+    liberarHash(hash);
+    inicializarHash(hash);
+    hash->arena = arena;
+    hash->fixas = fixas;
+    hash->concorrente = tc;
+}
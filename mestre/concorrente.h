@@ -0,0 +1,50 @@
+/* concorrente.h – tabela pista -> suspeito atualizável durante o lote */
+#ifndef MESTRE_CONCORRENTE_H
+#define MESTRE_CONCORRENTE_H
+
+#include "tabela.h"
+
+#define LEITORES_MAX 1024            // threads leitoras registradas ao mesmo tempo nas tabelas concorrentes
+
+/* Versão da tabela concorrente: capacidade fixa; crescer é publicar uma versão nova.
+   Cada slot é uma palavra de 64 bits (pista << 32 | suspeito, 0 = vazio), então o
+   leitor vê o par inteiro ou nada, nunca uma pista com o suspeito de outra. */
+typedef struct VersaoConcorrente {
+    size_t capacidade;                    // potência de 2
+    uint64_t epoca;                       // época global em que foi aposentada
+    struct VersaoConcorrente *proxima;    // fila de versões aposentadas
+    FiltroBloom filtro;                   // das pistas desta versão (no mesmo bloco de memória)
+    _Atomic uint64_t slots[];
+} VersaoConcorrente;
+
+/* Tabela pista -> suspeito atualizável enquanto as sessões leem. Escritores se revezam
+   num mutex; leitores não travam: anunciam a época, carregam a versão atual e sondam
+   linearmente. Entradas nunca saem (são substituídas no lugar), então a sondagem para no
+   primeiro slot vazio. Versões trocadas ao crescer só são liberadas quando nenhum leitor
+   anunciado pode mais estar nelas (reclamação por épocas). */
+typedef struct TabelaConcorrente {
+    _Atomic(VersaoConcorrente*) atual;
+    pthread_mutex_t escrita;
+    size_t tamanho;                       // daqui para baixo, só com 'escrita' travado
+    VersaoConcorrente *aposentadas;
+    unsigned long substituicoes, crescimentos, recuperadas;
+} TabelaConcorrente;
+
+/* iniciarConcorrente() / liberarConcorrente() – tabela pista -> suspeito para atualizar
+   com sessões em andamento. Liberar só depois que nenhuma thread a consulta mais.
+   tornarHashConcorrente() – move as associações dinâmicas da tabela para 'tc': daí em
+   diante inserirNaHashId e encontrarSuspeitoId usam 'tc' (as fixas continuam valendo). */
+void iniciarConcorrente(TabelaConcorrente *tc);
+void liberarConcorrente(TabelaConcorrente *tc);
+void tornarHashConcorrente(TabelaHash *hash, TabelaConcorrente *tc);
+
+/* inserirConcorrente() – adiciona ou substitui (escrita atômica do par) a associação;
+   escritores se revezam. buscarConcorrente() – nunca trava nem espera escritores. */
+void inserirConcorrente(TabelaConcorrente *tc, IdTexto pista, IdTexto suspeito);
+IdTexto buscarConcorrente(const TabelaConcorrente *tc, IdTexto pista);
+
+/* liberarLeitorConcorrente() – devolve o slot de leitor da thread atual (ocupado na
+   primeira consulta); chamar antes de encerrar threads que consultaram tabelas concorrentes. */
+void liberarLeitorConcorrente(void);
+
+#endif
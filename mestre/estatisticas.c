@@ -0,0 +1,153 @@
+/* estatisticas.c – estatísticas opcionais do motor (-DDETECTIVE_ESTATISTICAS): contadores
+   e relatório */
+
+#include "estatisticas.h"
+#include "textos.h"
+#include "associacoes.h"
+#include "concorrente.h"
+#include "paginada.h"
+#include "pistas.h"
+#include "trie.h"
+
+#ifdef DETECTIVE_ESTATISTICAS
+Estatisticas estatisticas;
+
+uint64_t relogioNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+void registrarConsulta(size_t sondagens) {
+    size_t faixa = sondagens - 1 < FAIXAS_SONDAGEM - 1 ? sondagens - 1 : FAIXAS_SONDAGEM - 1;
+    atomic_fetch_add_explicit(&estatisticas.consultas, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas.sondagens, sondagens, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas.sondagensPorConsulta[faixa], 1, memory_order_relaxed);
+}
+
+void registrarPasso(uint64_t ns) {
+    int faixa = 0;
+    while (faixa < FAIXAS_LATENCIA - 1 && (ns >> (faixa + 1)) != 0) faixa++;
+    atomic_fetch_add_explicit(&estatisticas.passos, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas.nsPassos, ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&estatisticas.latencia[faixa], 1, memory_order_relaxed);
+}
+#endif
+
+#ifdef DETECTIVE_ESTATISTICAS
+/* ------------------ Estatísticas ------------------ */
+
+static const char *nomesAlocacoes[TOTAL_ALOCACOES] = {
+    "arena (blocos)", "salas", "pistas", "tabela hash", "textos",
+    "sessão", "saída", "mansão plana/percursos", "lote", "mapa binário", "trie de pistas",
+    "rotas", "processo"
+};
+
+/* taxaEstimadaFiltro: chance de uma chave ausente passar = média, por bloco, do produto
+   das frações de bits ligados nas 8 palavras (cada uma testa um bit) */
+static double taxaEstimadaFiltro(const FiltroBloom *f) {
+    double soma = 0.0;
+    for (size_t b = 0; b < f->blocos; b++) {
+        double p = 1.0;
+        for (int i = 0; i < 8; i++)
+            p *= __builtin_popcountll(atomic_load_explicit(&f->palavras[8 * b + i], memory_order_relaxed)) / 64.0;
+        soma += p;
+    }
+    return f->blocos ? soma / (double) f->blocos : 0.0;
+}
+
+/* relatarTabela: ocupação e distâncias ao slot ideal (= sondagens de uma busca com acerto - 1) */
+static void relatarTabela(FILE *f, const char *nome, const TabelaHash *t) {
+    unsigned long faixas[FAIXAS_SONDAGEM] = { 0 };
+    size_t somaDist = 0, maxDist = 0;
+    for (size_t i = 0; i < t->capacidade; i++) {
+        if (t->hashes[i] == 0) continue;
+        size_t d = distanciaSlot(t, i);
+        faixas[d < FAIXAS_SONDAGEM - 1 ? d : FAIXAS_SONDAGEM - 1]++;
+        somaDist += d;
+        if (d > maxDist) maxDist = d;
+    }
+    fprintf(f, "%s: %zu/%zu slots (carga %.3f), sondagens por acerto: média %.2f, máx %zu\n",
+            nome, t->tamanho, t->capacidade,
+            t->capacidade ? (double) t->tamanho / (double) t->capacidade : 0.0,
+            t->tamanho ? 1.0 + (double) somaDist / (double) t->tamanho : 0.0, maxDist + 1);
+    for (int k = 0; k < FAIXAS_SONDAGEM; k++)
+        if (faixas[k])
+            fprintf(f, "  %2d%s sondagem(ns): %lu\n", k + 1, k == FAIXAS_SONDAGEM - 1 ? "+" : " ", faixas[k]);
+}
+
+/* relatarEstatisticas: contadores primeiro (os percursos abaixo também alocam) */
+void relatarEstatisticas(FILE *f, const Mansao *mansao, const TabelaHash *hash, const Sessao *sessao) {
+    fprintf(f, "\n=== Estatísticas do motor ===\n");
+    fprintf(f, "Alocações (malloc/realloc) por estrutura:\n");
+    for (int e = 0; e < TOTAL_ALOCACOES; e++) {
+        unsigned long n = atomic_load_explicit(&estatisticas.alocacoes[e], memory_order_relaxed);
+        if (n) fprintf(f, "  %8lu  %s\n", n, nomesAlocacoes[e]);
+    }
+
+    unsigned long passos = atomic_load_explicit(&estatisticas.passos, memory_order_relaxed);
+    unsigned long ns = atomic_load_explicit(&estatisticas.nsPassos, memory_order_relaxed);
+    fprintf(f, "Passos de explorarSalas: %lu, média %.0f ns (sem a espera pela jogada)\n",
+            passos, passos ? (double) ns / (double) passos : 0.0);
+    for (int k = 0; k < FAIXAS_LATENCIA; k++) {
+        unsigned long n = atomic_load_explicit(&estatisticas.latencia[k], memory_order_relaxed);
+        if (n) fprintf(f, "  [%llu, %llu) ns: %lu\n", 1ULL << k, 1ULL << (k + 1), n);
+    }
+
+    unsigned long consultas = atomic_load_explicit(&estatisticas.consultas, memory_order_relaxed);
+    unsigned long sondagens = atomic_load_explicit(&estatisticas.sondagens, memory_order_relaxed);
+    fprintf(f, "Buscas nas tabelas hash: %lu, média %.2f sondagens\n",
+            consultas, consultas ? (double) sondagens / (double) consultas : 0.0);
+    for (int k = 0; k < FAIXAS_SONDAGEM; k++) {
+        unsigned long n = atomic_load_explicit(&estatisticas.sondagensPorConsulta[k], memory_order_relaxed);
+        if (n) fprintf(f, "  %2d%s sondagem(ns): %lu\n", k + 1, k == FAIXAS_SONDAGEM - 1 ? "+" : " ", n);
+    }
+
+    unsigned long testadas = atomic_load_explicit(&estatisticas.filtroConsultas, memory_order_relaxed);
+    unsigned long rejeitadas = atomic_load_explicit(&estatisticas.filtroRejeitadas, memory_order_relaxed);
+    unsigned long falsos = atomic_load_explicit(&estatisticas.filtroFalsos, memory_order_relaxed);
+    const FiltroBloom *filtro = !hash ? NULL : hash->concorrente
+        ? &atomic_load_explicit(&hash->concorrente->atual, memory_order_acquire)->filtro : &hash->filtro;
+    if (filtro && filtro->palavras) {
+        fprintf(f, "Filtro de Bloom: %zu bytes, %lu pistas testadas, %lu rejeitadas sem sondar; "
+                   "falsos positivos %lu", filtro->blocos * 8 * sizeof(uint64_t), testadas, rejeitadas, falsos);
+        // sem pistas ausentes testadas não há taxa medida: 0% seria uma medição que não houve
+        if (rejeitadas + falsos)
+            fprintf(f, " (%.2f%% das ausentes)", 100.0 * (double) falsos / (double) (rejeitadas + falsos));
+        fprintf(f, ", estimado pelos bits %.2f%%\n", 100.0 * taxaEstimadaFiltro(filtro));
+    } else if (filtro) {
+        fprintf(f, "Filtro de Bloom: inativo (menos de %d associações)\n", FILTRO_ENTRADAS_MINIMAS);
+    }
+    if (hash && hash->concorrente) {
+        const TabelaConcorrente *tc = hash->concorrente;
+        fprintf(f, "Tabela pista -> suspeito (concorrente): %zu/%zu slots, %lu substituições, "
+                   "%lu crescimentos, %lu versões liberadas\n", tc->tamanho,
+                atomic_load_explicit(&tc->atual, memory_order_acquire)->capacidade,
+                tc->substituicoes, tc->crescimentos, tc->recuperadas);
+    } else if (hash) {
+        relatarTabela(f, "Tabela pista -> suspeito", hash);
+    }
+#ifdef COM_ASSOCIACOES_FIXAS
+    if (hash && hash->fixas)
+        fprintf(f, "Associações fixas (hash perfeito): %u em %u slots, 1 sondagem por consulta\n",
+                TOTAL_ASSOCIACOES_FIXAS, TOTAL_ASSOCIACOES_FIXAS);
+#endif
+    relatarTabela(f, "Índice de textos", &textosGlobais.indice);
+    if (mansao && mansao->paginada) {
+        const MansaoPaginada *pg = mansao->paginada;
+        unsigned long consultas = pg->acertos + pg->leituras;
+        fprintf(f, "Mansão paginada: %u salas no arquivo, %u/%u residentes, %lu leituras, "
+                   "acertos no cache %.1f%%, %zu pistas e %zu textos traduzidos\n",
+                pg->cab.totalSalas, pg->ocupadas, pg->capacidade, pg->leituras,
+                consultas ? 100.0 * (double) pg->acertos / (double) consultas : 0.0,
+                pg->pistas.tamanho, pg->textos.tamanho);
+    } else if (mansao) {
+        fprintf(f, "Mansão (%s): %u salas, profundidade %u\n",
+                mansao->plana ? "layout plano" : "árvore de Sala",
+                contarSalas(mansao), profundidadeMansao(mansao));
+    }
+    if (sessao)
+        fprintf(f, "Árvore de pistas: %u nós, profundidade %d\n",
+                tamanhoPista(sessao->raizPistas), alturaPista(sessao->raizPistas));
+}
+#endif
@@ -0,0 +1,13 @@
+/* estatisticas.h – relatório das estatísticas opcionais do motor */
+#ifndef MESTRE_ESTATISTICAS_H
+#define MESTRE_ESTATISTICAS_H
+
+#include "sessao.h"
+
+#ifdef DETECTIVE_ESTATISTICAS
+/* relatarEstatisticas() – contadores acumulados, ocupação e sondagens das tabelas e formato
+   das árvores. 'sessao' e 'hash' podem ser NULL (no lote não há uma sessão única). */
+void relatarEstatisticas(FILE *f, const Mansao *mansao, const TabelaHash *hash, const Sessao *sessao);
+#endif
+
+#endif
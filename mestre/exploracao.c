@@ -0,0 +1,416 @@
+/* exploracao.c – exploração da mansão e fase final (pistas, ranking, prefixos e julgamento) */
+
+#include "exploracao.h"
+#include "associacoes.h"
+#include "estatisticas.h"
+#include "instantaneo.h"
+#include "textos.h"
+
+/* emitir: sem saída configurada vai direto ao stdout; silenciosa não formata nada */
+void emitir(Saida *saida, const char *formato, ...) {
+    va_list args;
+    if (!saida) {
+        va_start(args, formato);
+        vprintf(formato, args);
+        va_end(args);
+        return;
+    }
+    if (saida->silenciosa) return;
+    for (;;) {
+        size_t livre = saida->cap - saida->tam;
+        va_start(args, formato);
+        int n = vsnprintf(saida->buf ? saida->buf + saida->tam : NULL, livre, formato, args);
+        va_end(args);
+        if (n < 0) return;
+        if ((size_t) n < livre) { saida->tam += (size_t) n; return; }
+        size_t cap = saida->cap ? saida->cap : 4096;
+        while (cap - saida->tam <= (size_t) n) cap *= 2;
+        ESTAT_ALOCACAO(ALOC_SAIDA, 1);
+        char *b = (char*) realloc(saida->buf, cap);
+        if (!b) { perror("realloc"); exit(EXIT_FAILURE); }
+        saida->buf = b;
+        saida->cap = cap;
+    }
+}
+
+/* lerOpcao: próximo movimento do roteiro (fim = 's') ou do teclado */
+static char lerOpcao(Sessao *sessao) {
+    char opcao;
+    if (sessao->roteiro) {
+        opcao = *sessao->roteiro ? *sessao->roteiro++ : 's';
+        emitir(sessao->saida, "%c\n", opcao);
+        return opcao;
+    }
+    if (scanf(" %c", &opcao) != 1) opcao = 's';   // fim da entrada encerra a exploração
+    return opcao;
+}
+
+/* descartarRamos: bifurcações guardadas que não foram retomadas */
+static void descartarRamos(Sessao *ramos, size_t total) {
+    for (size_t i = 0; i < total; i++) liberarSessao(&ramos[i]);
+    free(ramos);
+}
+
+/* explorarSalas: interação do jogador; coleta pistas automaticamente. Com o histórico,
+   cada movimento marca um ponto de retorno e as bifurcações ficam numa pilha de ramos. */
+void explorarSalas(const Mansao *mansao, Sessao *sessao, const TabelaHash *hash) {
+    Saida *out = sessao->saida;
+    int historico = sessao->historico.ativo;
+    Sessao *ramos = NULL;
+    size_t totalRamos = 0, capRamos = 0;
+    // sessão retomada: recomeça na sala salva, cuja pista já está contada
+    int retomando = posicaoValida(mansao, sessao->atual);
+    PosicaoSala atual = retomando ? sessao->atual : posicaoInicial(mansao);
+    // com rotas, a sala também é acompanhada pelo número em pré-ordem
+    const MapaRotas *rotas = sessao->rotas && sessao->rotas->total ? sessao->rotas : NULL;
+    uint32_t numero = 0;
+    if (rotas && retomando) localizarPreordem(mansao, &atual, &numero, 0);
+    while (posicaoValida(mansao, atual)) {
+        ESTAT_INICIO(inicioPasso);
+        sessao->atual = atual;
+        sessao->numeroAtual = numero;
+        emitir(out, "\nVocê está em: %s\n", nomeDaPosicao(mansao, atual));
+
+        // cada chegada a uma sala coleta a pista, com ou sem rotas (voltar também é chegar)
+        IdTexto pista = pistaDaPosicao(mansao, atual);
+        if (pista != SEM_TEXTO && retomando) {
+            emitir(out, "🔎 Pista já coletada aqui: \"%s\"\n", textoDe(pista));
+        } else if (pista != SEM_TEXTO) {
+            emitir(out, "🔎 Pista encontrada: \"%s\"\n", textoDe(pista));
+            // Adiciona à BST de pistas e atualiza os contadores de evidência
+            coletarPista(sessao, hash, pista);
+        } else {
+            emitir(out, "Nenhuma pista neste cômodo.\n");
+        }
+
+        // Menu de navegação
+        PosicaoSala esq = filhoDaPosicao(mansao, atual, 0);
+        PosicaoSala dir = filhoDaPosicao(mansao, atual, 1);
+        int temEsq = posicaoValida(mansao, esq), temDir = posicaoValida(mansao, dir);
+        emitir(out, "\nEscolha o caminho:\n");
+        if (temEsq) emitir(out, "(e) Esquerda -> %s\n", nomeDaPosicao(mansao, esq));
+        if (temDir) emitir(out, "(d) Direita  -> %s\n", nomeDaPosicao(mansao, dir));
+        uint32_t pai = rotas ? rotas->pai[numero] : SALA_NENHUMA;
+        if (pai != SALA_NENHUMA) emitir(out, "(v) Voltar   -> %s\n", nomeDaPosicao(mansao, rotas->posicoes[pai]));
+        if (rotas) emitir(out, "(r) Rota até a pista nova mais próxima\n");
+        if (historico) emitir(out, "(u) Desfazer o último passo\n(b) Guardar uma bifurcação aqui\n"
+                                   "(a) Abandonar o ramo e voltar à última bifurcação\n");
+        if (sessao->gravarEm) emitir(out, "(g) Gravar a sessão e parar aqui\n");
+#ifdef DETECTIVE_ESTATISTICAS
+        emitir(out, "(x) Estatísticas do motor\n");
+#endif
+        emitir(out, "(s) Sair e apresentar as pistas coletadas\n> ");
+        ESTAT_PASSO(inicioPasso);   // a espera pela jogada fica fora da latência
+        char opcao = lerOpcao(sessao);
+        retomando = 0;
+
+        if (opcao == 'e' || opcao == 'E') {
+            if (temEsq && historico) marcarPasso(sessao);
+            if (temEsq) atual = esq;
+            else emitir(out, "⚠️  Caminho inexistente à esquerda!\n");
+            if (temEsq && rotas) numero = rotas->filhos[2 * (size_t) numero];
+        } else if (opcao == 'd' || opcao == 'D') {
+            if (temDir && historico) marcarPasso(sessao);
+            if (temDir) atual = dir;
+            else emitir(out, "⚠️  Caminho inexistente à direita!\n");
+            if (temDir && rotas) numero = rotas->filhos[2 * (size_t) numero + 1];
+        } else if (rotas && (opcao == 'v' || opcao == 'V')) {
+            if (pai != SALA_NENHUMA && historico) marcarPasso(sessao);
+            if (pai != SALA_NENHUMA) atual = rotas->posicoes[numero = pai];
+            else emitir(out, "⚠️  Você já está na entrada!\n");
+        } else if (rotas && (opcao == 'r' || opcao == 'R')) {
+            retomando = 1;   // pedir a dica não é chegar de novo à sala
+            uint32_t alvo = pistaNovaMaisProxima(rotas, sessao, numero);
+            char passos[ROTA_EXIBIDA + 1];
+            if (alvo == SALA_NENHUMA) {
+                emitir(out, "🧭 Nenhuma pista nova na mansão.\n");
+            } else {
+                uint32_t n = rotaEntreSalas(rotas, numero, alvo, passos, sizeof(passos));
+                emitir(out, "🧭 Pista nova mais próxima: %s, a %u passo(s): %s%s\n",
+                       nomeDaPosicao(mansao, rotas->posicoes[alvo]), n, passos, n > ROTA_EXIBIDA ? "..." : "");
+            }
+        } else if (historico && (opcao == 'u' || opcao == 'U')) {
+            // u, b e a nunca recoletam: a sala onde se fica (ou a que volta) já foi contada
+            retomando = 1;
+            if (desfazerPasso(sessao) == 0) {
+                atual = sessao->atual;
+                numero = sessao->numeroAtual;
+                emitir(out, "↩️  Passo desfeito.\n");
+            } else {
+                emitir(out, "⚠️  Nada a desfazer!\n");
+            }
+        } else if (historico && (opcao == 'b' || opcao == 'B')) {
+            retomando = 1;
+            if (totalRamos == capRamos) {
+                capRamos = capRamos ? capRamos * 2 : 4;
+                ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+                ramos = (Sessao*) realloc(ramos, capRamos * sizeof(Sessao));
+                if (!ramos) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            bifurcarSessao(sessao, &ramos[totalRamos++]);
+            emitir(out, "🔀 Bifurcação guardada em %s (%zu guardada(s)).\n",
+                   nomeDaPosicao(mansao, atual), totalRamos);
+        } else if (historico && (opcao == 'a' || opcao == 'A')) {
+            retomando = 1;
+            if (totalRamos > 0) {
+                // o ramo guardado segue com o roteiro e a saída de agora
+                Sessao ramo = ramos[--totalRamos];
+                ramo.roteiro = sessao->roteiro;
+                ramo.saida = sessao->saida;
+                liberarSessao(sessao);
+                *sessao = ramo;
+                atual = sessao->atual;
+                numero = sessao->numeroAtual;
+                emitir(out, "🔀 Ramo abandonado: de volta à bifurcação.\n");
+            } else {
+                emitir(out, "⚠️  Nenhuma bifurcação guardada!\n");
+            }
+        } else if (sessao->gravarEm && (opcao == 'g' || opcao == 'G')) {
+            // a sala atual já foi contada: quem retomar recomeça nela sem recoletar
+            if (salvarSessao(sessao->gravarEm, mansao, sessao) == 0) {
+                emitir(out, "💾 Sessão gravada em %s; continue com --retomar %s\n", sessao->gravarEm, sessao->gravarEm);
+                sessao->suspensa = 1;
+                break;
+            }
+            emitir(out, "⚠️  Não foi possível gravar a sessão!\n");
+            retomando = 1;
+        } else if (opcao == 's' || opcao == 'S') {
+            emitir(out, "\nVocê decidiu encerrar a exploração.\n");
+            break;
+#ifdef DETECTIVE_ESTATISTICAS
+        } else if (opcao == 'x' || opcao == 'X') {
+            relatarEstatisticas(stderr, mansao, hash, sessao);
+#endif
+        } else {
+            emitir(out, "Opção inválida. Use 'e', 'd'%s%s%s ou 's'.\n",
+                   rotas ? ", 'v', 'r'" : "", historico ? ", 'u', 'b', 'a'" : "", sessao->gravarEm ? ", 'g'" : "");
+        }
+    }
+    descartarRamos(ramos, totalRamos);
+}
+
+/* escreverPistas: percorre BST em ordem e emite pista + ocorrencias */
+static void escreverPistas(const PistaNode *raiz, Saida *saida) {
+    IteradorPistas it;
+    iniciarIterador(&it, raiz);
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; )
+        emitir(saida, " - \"%s\" (x%d)\n", textoDe(n->pista), n->ocorrencias);
+}
+
+/* exibirPistas: imprime a árvore em ordem no stdout */
+void exibirPistas(PistaNode *raiz) {
+    escreverPistas(raiz, NULL);
+}
+
+/* apresentarPistas: lista ordenada e suspeito mais provável */
+void apresentarPistas(Sessao *sessao) {
+    emitir(sessao->saida, "\n📜 Pistas coletadas (ordenadas):\n");
+    if (!sessao->raizPistas) {
+        emitir(sessao->saida, "Nenhuma pista coletada.\n");
+        return;
+    }
+    escreverPistas(sessao->raizPistas, sessao->saida);
+    IdTexto provavel = suspeitoMaisProvavel(sessao);
+    if (provavel != SEM_TEXTO)
+        emitir(sessao->saida, "\n🧠 Suspeito mais provável: %s (%d pista(s))\n",
+               textoDe(provavel), evidenciasDe(sessao, provavel));
+}
+
+/* apresentarRanking: os k suspeitos com mais evidências, lidos do heap da sessão */
+void apresentarRanking(Sessao *sessao, size_t k) {
+    IdTexto topo[RANKING_EXIBIDO];
+    if (k > RANKING_EXIBIDO) k = RANKING_EXIBIDO;
+    size_t n = suspeitosMaisProvaveis(sessao, topo, k);
+    if (n < 2) return;   // com um só suspeito, apresentarPistas já disse tudo
+    emitir(sessao->saida, "\n🏆 Ranking de suspeitos:\n");
+    for (size_t i = 0; i < n; i++)
+        emitir(sessao->saida, " %zu. %s (%d pista(s))\n", i + 1, textoDe(topo[i]),
+               evidenciasDe(sessao, topo[i]));
+}
+
+/* precedePontuacao: mais peso primeiro; no empate, mais pistas, depois a ordem alfabética
+   (os ids dependem da ordem de carga, que muda com o layout) */
+static int precedePontuacao(const PontuacaoSuspeito *a, const PontuacaoSuspeito *b) {
+    if (a->peso != b->peso) return a->peso > b->peso;
+    if (a->pistas != b->pistas) return a->pistas > b->pistas;
+    return strcmp(textoDe(a->suspeito), textoDe(b->suspeito)) < 0;
+}
+
+/* apresentarPonderado: todos os suspeitos pontuados de uma vez pelos bitsets; os k de
+   maior peso saem por seleção parcial (k é pequeno) */
+void apresentarPonderado(Sessao *sessao, size_t k) {
+    const Processo *p = sessao->processo;
+    if (!p || p->totalSuspeitos == 0) return;
+    ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+    PontuacaoSuspeito *pts = (PontuacaoSuspeito*) malloc(p->totalSuspeitos * sizeof(PontuacaoSuspeito));
+    if (!pts) { perror("malloc"); exit(EXIT_FAILURE); }
+    pontuarSuspeitos(p, sessao->coletadas, pts);
+    emitir(sessao->saida, "\n⚖️ Pontuação ponderada do processo:\n");
+    size_t r = 0;
+    for (; r < k && r < p->totalSuspeitos; r++) {
+        size_t melhor = r;
+        for (size_t i = r + 1; i < p->totalSuspeitos; i++)
+            if (precedePontuacao(&pts[i], &pts[melhor])) melhor = i;
+        if (pts[melhor].peso == 0) break;
+        PontuacaoSuspeito t = pts[r]; pts[r] = pts[melhor]; pts[melhor] = t;
+        emitir(sessao->saida, " %zu. %s: peso %llu (%u pista(s))\n", r + 1, textoDe(pts[r].suspeito),
+               (unsigned long long) pts[r].peso, pts[r].pistas);
+    }
+    if (r == 0) emitir(sessao->saida, "Nenhuma pista coletada pesa no processo.\n");
+    free(pts);
+}
+
+/* emitirPistaTrie: visitante que lista a pista na saída da sessão */
+static int emitirPistaTrie(IdTexto pista, int ocorrencias, void *contexto) {
+    emitir((Saida*) contexto, " - \"%s\" (x%d)\n", textoDe(pista), ocorrencias);
+    return 0;
+}
+
+/* emitirPistaNo: visitante que lista o nó da árvore na saída da sessão */
+static int emitirPistaNo(const PistaNode *no, void *contexto) {
+    emitir((Saida*) contexto, " - \"%s\" (x%d)\n", textoDe(no->pista), no->ocorrencias);
+    return 0;
+}
+
+/* limiteDoPrefixo: o menor texto depois de todos os que começam com 'prefixo' (último byte
+   abaixo de 0xFF incrementado, o resto cortado) em 'ate', que tem strlen(prefixo) + 1 bytes.
+   Retorna 0 se não houver limite. */
+static int limiteDoPrefixo(const char *prefixo, char *ate) {
+    size_t L = strlen(prefixo);
+    while (L > 0 && (unsigned char) prefixo[L - 1] == 0xFF) L--;
+    if (L == 0) return 0;
+    memcpy(ate, prefixo, L);
+    ate[L - 1]++;
+    ate[L] = '\0';
+    return 1;
+}
+
+/* apresentarPrefixoArvore: com o histórico não há trie; o prefixo é o intervalo
+   [prefixo, limite) da árvore, contado e posicionado em O(log n) */
+static void apresentarPrefixoArvore(Sessao *sessao, const char *prefixo) {
+    char *ate = (char*) malloc(strlen(prefixo) + 1);
+    if (!ate) { perror("malloc"); exit(EXIT_FAILURE); }
+    uint64_t ocorrencias;
+    size_t distintas = contarIntervaloPistas(sessao->raizPistas, prefixo,
+                                             limiteDoPrefixo(prefixo, ate) ? ate : NULL, &ocorrencias);
+    free(ate);
+    emitir(sessao->saida, "\n🔤 Pistas que começam com \"%s\": %zu (%llu ocorrência(s))\n",
+           prefixo, distintas, (unsigned long long) ocorrencias);
+    size_t listadas = visitarPagina(sessao->raizPistas, posicaoDaPista(sessao->raizPistas, prefixo, NULL),
+                                    distintas < LIMITE_PREFIXO ? distintas : LIMITE_PREFIXO,
+                                    emitirPistaNo, sessao->saida);
+    if (distintas > listadas) emitir(sessao->saida, " ... e mais %zu\n", distintas - listadas);
+}
+
+/* triePistasDaSessao: a trie é montada na primeira consulta de prefixo, em ordem a partir
+   da árvore (O(n)); daí em diante coletarPista a mantém junto com a árvore */
+static const NoTrie* triePistasDaSessao(Sessao *sessao) {
+    if (!sessao->triePistas) {
+        IteradorPistas it;
+        iniciarIterador(&it, sessao->raizPistas);
+        for (const PistaNode *n; (n = proximaPista(&it)) != NULL; )
+            sessao->triePistas = somarNaTrie(sessao->triePistas, n->pista, n->ocorrencias);
+    }
+    return sessao->triePistas;
+}
+
+/* apresentarPrefixo: totais em O(k) pela trie e as primeiras LIMITE_PREFIXO pistas */
+void apresentarPrefixo(Sessao *sessao, const char *prefixo) {
+    if (sessao->historico.ativo) {
+        apresentarPrefixoArvore(sessao, prefixo);
+        return;
+    }
+    const NoTrie *trie = triePistasDaSessao(sessao);
+    int ocorrencias;
+    uint32_t distintas = contarPrefixo(trie, prefixo, &ocorrencias);
+    emitir(sessao->saida, "\n🔤 Pistas que começam com \"%s\": %u (%d ocorrência(s))\n",
+           prefixo, distintas, ocorrencias);
+    size_t listadas = visitarPrefixo(trie, prefixo, LIMITE_PREFIXO, emitirPistaTrie, sessao->saida);
+    if (distintas > listadas) emitir(sessao->saida, " ... e mais %zu\n", (size_t) distintas - listadas);
+}
+
+/* Página em andamento: saída e posição (1, 2, ...) da próxima pista listada */
+typedef struct PaginaPistas {
+    Saida *saida;
+    size_t posicao;
+} PaginaPistas;
+
+static int emitirPistaNumerada(const PistaNode *n, void *contexto) {
+    PaginaPistas *p = (PaginaPistas*) contexto;
+    emitir(p->saida, " %zu. \"%s\" (x%d)\n", p->posicao++, textoDe(n->pista), n->ocorrencias);
+    return 0;
+}
+
+/* apresentarPagina: só as PISTAS_POR_PAGINA pistas da página (a partir de 1) são visitadas;
+   o total e o início da página saem dos tamanhos das subárvores */
+void apresentarPagina(Sessao *sessao, size_t pagina) {
+    size_t total = tamanhoPista(sessao->raizPistas);
+    size_t paginas = (total + PISTAS_POR_PAGINA - 1) / PISTAS_POR_PAGINA;
+    if (pagina == 0 || pagina > paginas) {
+        emitir(sessao->saida, "\n📄 Página %zu inexistente: %zu pista(s) em %zu página(s).\n",
+               pagina, total, paginas);
+        return;
+    }
+    size_t inicio = (pagina - 1) * PISTAS_POR_PAGINA;
+    size_t fim = inicio + PISTAS_POR_PAGINA < total ? inicio + PISTAS_POR_PAGINA : total;
+    emitir(sessao->saida, "\n📄 Pistas coletadas, página %zu de %zu (%zu a %zu de %zu):\n",
+           pagina, paginas, inicio + 1, fim, total);
+    PaginaPistas p = { sessao->saida, inicio + 1 };
+    visitarPagina(sessao->raizPistas, inicio, PISTAS_POR_PAGINA, emitirPistaNumerada, &p);
+}
+
+/* apresentarPosicao: posição alfabética da pista entre as coletadas (ou onde entraria) */
+void apresentarPosicao(Sessao *sessao, const char *pista) {
+    uint64_t antes;
+    size_t posicao = posicaoDaPista(sessao->raizPistas, pista, &antes);
+    size_t total = tamanhoPista(sessao->raizPistas);
+    const PistaNode *n = selecionarPista(sessao->raizPistas, posicao);
+    if (n && strcmp(textoDe(n->pista), pista) == 0)
+        emitir(sessao->saida, "\n🔢 \"%s\" é a pista %zu de %zu (página %zu; %llu ocorrência(s) antes dela).\n",
+               pista, posicao + 1, total, posicao / PISTAS_POR_PAGINA + 1, (unsigned long long) antes);
+    else
+        emitir(sessao->saida, "\n🔢 \"%s\" não foi coletada; entraria na posição %zu de %zu.\n",
+               pista, posicao + 1, total + 1);
+}
+
+/* julgarAcusacao: aplica a regra das >= 2 pistas e anuncia o resultado */
+Veredito julgarAcusacao(Sessao *sessao, const char *acusado) {
+    Saida *out = sessao->saida;
+    if (!acusado || strlen(acusado) == 0) {
+        emitir(out, "Nenhum acusado informado. Encerrando sem julgamento.\n");
+        return SEM_JULGAMENTO;
+    }
+    int total = verificarAcusacao(sessao, acusado);
+    emitir(out, "\nResultado da acusação contra \"%s\":\n", acusado);
+    if (total >= 2) {
+        emitir(out, "✅ Há %d pistas que apontam para %s. Acusação sustentada!\n", total, acusado);
+        return ACUSACAO_SUSTENTADA;
+    } else if (total == 1) {
+        emitir(out, "⚠️ Apenas 1 pista aponta para %s. Provas insuficientes para condenar.\n", acusado);
+        return PROVAS_INSUFICIENTES;
+    }
+    emitir(out, "❌ Nenhuma pista coletada aponta para %s. Acusação infundada.\n", acusado);
+    return ACUSACAO_INFUNDADA;
+}
+
+/* contarPistasDoSuspeito: percorre a árvore comparando apenas ids */
+static int contarPistasDoSuspeito(const PistaNode *raiz, const TabelaHash *hash, IdTexto acusado) {
+    int total = 0;
+    IteradorPistas it;
+    iniciarIterador(&it, raiz);
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; )
+        if (encontrarSuspeitoId(hash, n->pista) == acusado) total += n->ocorrencias;
+    return total;
+}
+
+/* verificarSuspeitoFinal: resolve o nome do acusado uma vez e conta as pistas que apontam para ele */
+int verificarSuspeitoFinal(PistaNode *raiz, const TabelaHash *hash, const char *acusado) {
+    IdTexto id = buscarTexto(acusado);
+    if (id == SEM_TEXTO) return 0; // nome nunca visto: nenhuma pista pode apontar para ele
+    return contarPistasDoSuspeito(raiz, hash, id);
+}
+
+/* verificarAcusacao: consulta direta ao contador do acusado */
+int verificarAcusacao(const Sessao *sessao, const char *acusado) {
+    return evidenciasDe(sessao, buscarTexto(acusado));
+}
@@ -0,0 +1,44 @@
+/* exploracao.h – exploração da mansão e fase final */
+#ifndef MESTRE_EXPLORACAO_H
+#define MESTRE_EXPLORACAO_H
+
+#include "sessao.h"
+
+#define RANKING_EXIBIDO 3            // suspeitos mostrados no ranking final
+#define LIMITE_PREFIXO 10            // pistas listadas por consulta de prefixo
+#define PISTAS_POR_PAGINA 20         // pistas por página na listagem paginada
+
+/* Resultado do julgamento final */
+typedef enum {
+    SEM_JULGAMENTO = -1,
+    ACUSACAO_INFUNDADA = 0,
+    PROVAS_INSUFICIENTES = 1,
+    ACUSACAO_SUSTENTADA = 2
+} Veredito;
+
+/* emitir() – printf para a saída da sessão (buffer, descarte ou stdout). */
+void emitir(Saida *saida, const char *formato, ...);
+
+/* explorarSalas() – navega pela mansão (qualquer layout) e ativa o sistema de pistas.
+   Os movimentos vêm de sessao->roteiro, se houver, ou do teclado. */
+void explorarSalas(const Mansao *mansao, Sessao *sessao, const TabelaHash *hash);
+
+/* exibirPistas() – imprime a árvore de pistas em ordem alfabética. */
+void exibirPistas(PistaNode *raiz);
+
+/* apresentarPistas() / julgarAcusacao() – fase final na saída da sessão. */
+void apresentarPistas(Sessao *sessao);
+void apresentarPrefixo(Sessao *sessao, const char *prefixo);
+void apresentarPagina(Sessao *sessao, size_t pagina);
+void apresentarPosicao(Sessao *sessao, const char *pista);
+void apresentarRanking(Sessao *sessao, size_t k);
+void apresentarPonderado(Sessao *sessao, size_t k);
+Veredito julgarAcusacao(Sessao *sessao, const char *acusado);
+
+/* verificarSuspeitoFinal() – conduz à fase de julgamento final.
+   Retorna o número de pistas que apontam para o suspeito acusado.
+   verificarAcusacao() dá o mesmo resultado em O(1) pelos contadores da sessão. */
+int verificarSuspeitoFinal(PistaNode *raiz, const TabelaHash *hash, const char *acusado);
+int verificarAcusacao(const Sessao *sessao, const char *acusado);
+
+#endif
@@ -0,0 +1,135 @@
+/* hash.c – funções de hash: djb2, hash de textos vetorizado (escalar/SSE2/AVX2) e hash de ids */
+
+#include "hash.h"
+
+/* hash function djb2 (valor completo; a tabela aplica a máscara da capacidade) */
+unsigned long hash_djb2(const char *str) {
+    unsigned long hash = 5381;
+    int c;
+    while ((c = (unsigned char)*str++))
+        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+    return hash;
+}
+
+/* misturar64: finalizador do splitmix64 (espalha a entropia por todos os bits) */
+uint64_t misturar64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* Hash de textos: HASH_FAIXAS faixas de 32 bits consomem blocos de HASH_BLOCO bytes
+   (a faixa j recebe a palavra j de cada bloco), sem dependência entre faixas. O resto
+   do texto e o fechamento são escalares e comuns a todos os kernels, então escalar,
+   SSE2 e AVX2 produzem exatamente o mesmo valor. */
+typedef void (*KernelHash)(uint32_t *faixas, const unsigned char *p, size_t blocos);
+
+static void faixasEscalar(uint32_t *faixas, const unsigned char *p, size_t blocos) {
+    for (size_t b = 0; b < blocos; b++, p += HASH_BLOCO) {
+        for (int j = 0; j < HASH_FAIXAS; j++) {
+            uint32_t w;
+            memcpy(&w, p + 4 * j, sizeof(w));
+            uint32_t v = (faixas[j] ^ w) * HASH_PRIMO32;
+            faixas[j] = (v << 13) | (v >> 19);
+        }
+    }
+}
+
+#if defined(__SSE2__)
+/* multiplicar32: produto 32x32 (bits baixos) por faixa; o SSE2 só multiplica as faixas pares */
+static inline __m128i multiplicar32(__m128i x, __m128i y) {
+    __m128i pares = _mm_mul_epu32(x, y);
+    __m128i impares = _mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(pares, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(impares, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static void faixasSse2(uint32_t *faixas, const unsigned char *p, size_t blocos) {
+    const __m128i primo = _mm_set1_epi32((int) HASH_PRIMO32);
+    __m128i f[HASH_FAIXAS / 4];
+    for (int r = 0; r < HASH_FAIXAS / 4; r++) f[r] = _mm_loadu_si128((const __m128i*) (faixas + 4 * r));
+    for (size_t k = 0; k < blocos; k++, p += HASH_BLOCO) {
+        for (int r = 0; r < HASH_FAIXAS / 4; r++) {
+            __m128i v = multiplicar32(_mm_xor_si128(f[r], _mm_loadu_si128((const __m128i*) (p + 16 * r))), primo);
+            f[r] = _mm_or_si128(_mm_slli_epi32(v, 13), _mm_srli_epi32(v, 19));
+        }
+    }
+    for (int r = 0; r < HASH_FAIXAS / 4; r++) _mm_storeu_si128((__m128i*) (faixas + 4 * r), f[r]);
+}
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HASH_COM_AVX2 1
+__attribute__((target("avx2")))
+static void faixasAvx2(uint32_t *faixas, const unsigned char *p, size_t blocos) {
+    const __m256i primo = _mm256_set1_epi32((int) HASH_PRIMO32);
+    __m256i f[HASH_FAIXAS / 8];
+    for (int r = 0; r < HASH_FAIXAS / 8; r++) f[r] = _mm256_loadu_si256((const __m256i*) (faixas + 8 * r));
+    for (size_t k = 0; k < blocos; k++, p += HASH_BLOCO) {
+        for (int r = 0; r < HASH_FAIXAS / 8; r++) {
+            __m256i v = _mm256_mullo_epi32(_mm256_xor_si256(f[r], _mm256_loadu_si256((const __m256i*) (p + 32 * r))), primo);
+            f[r] = _mm256_or_si256(_mm256_slli_epi32(v, 13), _mm256_srli_epi32(v, 19));
+        }
+    }
+    for (int r = 0; r < HASH_FAIXAS / 8; r++) _mm256_storeu_si256((__m256i*) (faixas + 8 * r), f[r]);
+}
+#endif
+
+/* kernel em uso: promovido por escolherKernelHash() ao melhor que a CPU suporta */
+static KernelHash kernelHash = faixasEscalar;
+
+/* escolherKernelHash: detecção da CPU, feita uma vez antes de qualquer hash de texto */
+void escolherKernelHash(void) {
+#if defined(__SSE2__)
+    kernelHash = faixasSse2;
+#endif
+#ifdef HASH_COM_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) kernelHash = faixasAvx2;
+#endif
+}
+
+/* hashComKernel: faixas pelo kernel dado; resto de 8 em 8 bytes e fechamento escalares */
+static uint64_t hashComKernel(const char *texto, size_t L, KernelHash kernel) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    size_t blocos = L / HASH_BLOCO;
+    if (blocos) {
+        // textos curtos (a maioria das pistas) nem passam pelas faixas
+        uint32_t faixas[HASH_FAIXAS];
+        for (int j = 0; j < HASH_FAIXAS; j++) faixas[j] = 0x243F6A88u + (uint32_t) j * HASH_PRIMO32;
+        kernel(faixas, (const unsigned char*) texto, blocos);
+        for (int j = 0; j < HASH_FAIXAS; j += 2)
+            h = (h ^ (((uint64_t) faixas[j + 1] << 32) | faixas[j])) * 0x9E3779B97F4A7C15ULL;
+    }
+    const char *p = texto + blocos * HASH_BLOCO;
+    size_t resto = L - blocos * HASH_BLOCO;
+    for (; resto >= 8; resto -= 8, p += 8) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+    }
+    if (resto) {
+        uint64_t w = 0;
+        memcpy(&w, p, resto);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+    }
+    return misturar64(h ^ (uint64_t) L);
+}
+
+/* hashTexto: hash de 64 bits do texto com o kernel escolhido para esta CPU */
+unsigned long hashTexto(const char *texto) {
+    return (unsigned long) hashComKernel(texto, strlen(texto), kernelHash);
+}
+
+/* hashChave: hash do texto reservando o valor 0 para marcar slot vazio */
+unsigned long hashChave(const char *texto) {
+    unsigned long h = hashTexto(texto);
+    return h ? h : 1;
+}
+
+/* hashId: espalha ids sequenciais pelos bits baixos */
+unsigned long hashId(IdTexto id) {
+    uint64_t x = misturar64((uint64_t) id + 0x9E3779B97F4A7C15ULL);
+    return x ? (unsigned long) x : 1;
+}
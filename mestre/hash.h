@@ -0,0 +1,30 @@
+/* hash.h – funções de hash de textos e de ids */
+#ifndef MESTRE_HASH_H
+#define MESTRE_HASH_H
+
+#include "comum.h"
+
+#define HASH_FAIXAS 16               // faixas de 32 bits do hash de textos
+#define HASH_BLOCO (HASH_FAIXAS * 4) // bytes consumidos por rodada das faixas
+#define HASH_PRIMO32 0x9E3779B1u
+
+/* hash_djb2() – hash djb2 clássico (valor completo; a tabela aplica a máscara da capacidade). */
+unsigned long hash_djb2(const char *str);
+
+/* hashTexto() – hash de 64 bits usado pelo índice de textos (SIMD quando a CPU permite;
+   o valor não depende do kernel). */
+unsigned long hashTexto(const char *texto);
+
+/* escolherKernelHash() – escolhe o kernel do hashTexto pela CPU; chamar uma vez antes do
+   primeiro hash de texto (internar() o faz). */
+void escolherKernelHash(void);
+
+/* misturar64() – finalizador do splitmix64: espalha a entropia por todos os bits. */
+uint64_t misturar64(uint64_t x);
+
+/* hashChave() / hashId() – hash de um texto ou de um id para as tabelas, nunca 0 (o valor
+   que marca slot vazio). */
+unsigned long hashChave(const char *texto);
+unsigned long hashId(IdTexto id);
+
+#endif
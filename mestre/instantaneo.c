@@ -0,0 +1,173 @@
+/* instantaneo.c – instantâneo de sessão (.dqs): gravação numa escrita e retomada com mmap */
+
+#include "instantaneo.h"
+#include "textos.h"
+
+/* compararPorTexto: ordem alfabética de IdTexto (suspeitos do instantâneo) */
+static int compararPorTexto(const void *a, const void *b) {
+    return strcmp(textoDe(*(const IdTexto*) a), textoDe(*(const IdTexto*) b));
+}
+
+int salvarSessao(const char *caminho, const Mansao *mansao, const Sessao *sessao) {
+    CabecalhoSessao cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, SESSAO_MAGIA, 4);
+    cab.versao = SESSAO_VERSAO;
+    cab.sala = SALA_NENHUMA;
+    cab.maisProvavel = UINT32_MAX;
+    PosicaoSala atual = sessao->atual;
+    if (posicaoValida(mansao, atual)) localizarPreordem(mansao, &atual, &cab.sala, 0);
+
+    IteradorPistas it;
+    iniciarIterador(&it, sessao->raizPistas);
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; cab.totalPistas++)
+        cab.tamTextos += strlen(textoDe(n->pista)) + 1;
+    // suspeitos em ordem alfabética, como as pistas: a leitura recusa repetidos sem tabela
+    IdTexto *suspeitos = (IdTexto*) malloc((sessao->capEvidencias ? sessao->capEvidencias : 1) * sizeof(IdTexto));
+    if (!suspeitos) { perror("malloc"); exit(EXIT_FAILURE); }
+    for (uint32_t i = 0; i < sessao->capEvidencias; i++) {
+        if (!sessao->evidencias[i]) continue;
+        suspeitos[cab.totalEvidencias++] = i;
+        cab.tamTextos += strlen(textoDe(i)) + 1;
+    }
+    qsort(suspeitos, cab.totalEvidencias, sizeof(IdTexto), compararPorTexto);
+
+    if (cab.tamTextos > UINT32_MAX) {   // offsets de 32 bits
+        fprintf(stderr, "%s: textos demais para um instantâneo\n", caminho);
+        free(suspeitos);
+        return -1;
+    }
+
+    // tudo num buffer: uma única escrita sequencial
+    size_t tam = sizeof(cab) + cab.totalPistas * sizeof(RegistroPista) +
+                 cab.totalEvidencias * sizeof(RegistroEvidencia) + cab.tamTextos;
+    unsigned char *buf = (unsigned char*) malloc(tam);
+    if (!buf) { perror("malloc"); exit(EXIT_FAILURE); }
+    RegistroPista *pistas = (RegistroPista*) (buf + sizeof(cab));
+    RegistroEvidencia *evid = (RegistroEvidencia*) (pistas + cab.totalPistas);
+    char *pool = (char*) (evid + cab.totalEvidencias);
+    uint32_t usado = 0;
+    size_t k = 0;
+    iniciarIterador(&it, sessao->raizPistas);
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; k++) {
+        size_t L = strlen(textoDe(n->pista)) + 1;
+        memcpy(pool + usado, textoDe(n->pista), L);
+        pistas[k].texto = usado;
+        pistas[k].ocorrencias = n->ocorrencias;
+        usado += (uint32_t) L;
+    }
+    for (k = 0; k < cab.totalEvidencias; k++) {
+        size_t L = strlen(textoDe(suspeitos[k])) + 1;
+        memcpy(pool + usado, textoDe(suspeitos[k]), L);
+        evid[k].texto = usado;
+        evid[k].total = sessao->evidencias[suspeitos[k]];
+        if (suspeitos[k] == sessao->maisProvavel) cab.maisProvavel = (uint32_t) k;
+        usado += (uint32_t) L;
+    }
+    free(suspeitos);
+    memcpy(buf, &cab, sizeof(cab));
+
+    FILE *f = fopen(caminho, "wb");
+    if (!f) { perror(caminho); free(buf); return -1; }
+    int erro = fwrite(buf, 1, tam, f) != tam;
+    if (fclose(f) != 0) erro = 1;
+    free(buf);
+    if (erro) { perror(caminho); return -1; }
+    return 0;
+}
+
+/* textoDoInstantaneo: texto no offset 'off' do pool, ou NULL se fora dele ou vazio (o
+   pool termina em '\0', verificado antes, então todo offset válido tem um texto inteiro) */
+static const char* textoDoInstantaneo(const char *pool, uint64_t tamPool, uint32_t off) {
+    return off < tamPool && pool[off] != '\0' ? pool + off : NULL;
+}
+
+int retomarSessao(const char *caminho, const Mansao *mansao, Sessao *sessao) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) { perror(caminho); return -1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { perror(caminho); close(fd); return -1; }
+    size_t tam = (size_t) st.st_size;
+    if (tam < sizeof(CabecalhoSessao)) {
+        fprintf(stderr, "%s: instantâneo truncado\n", caminho);
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) { perror("mmap"); return -1; }
+
+    const CabecalhoSessao *cab = (const CabecalhoSessao*) base;
+    const RegistroPista *pistas = (const RegistroPista*) (cab + 1);
+    const RegistroEvidencia *evid = (const RegistroEvidencia*) (pistas + cab->totalPistas);
+    const char *pool = (const char*) (evid + cab->totalEvidencias);
+    int valido = memcmp(cab->magia, SESSAO_MAGIA, 4) == 0 && cab->versao == SESSAO_VERSAO &&
+        tam == sizeof(*cab) + (uint64_t) cab->totalPistas * sizeof(RegistroPista) +
+               (uint64_t) cab->totalEvidencias * sizeof(RegistroEvidencia) + cab->tamTextos &&
+        (cab->maisProvavel == UINT32_MAX || cab->maisProvavel < cab->totalEvidencias) &&
+        (cab->tamTextos == 0 || pool[cab->tamTextos - 1] == '\0');
+    // textos não vazios dentro do pool, pistas e suspeitos em ordem estritamente crescente
+    // (como a gravação os deixa: sem repetidos)
+    const char *anterior = NULL;
+    for (uint32_t i = 0; valido && i < cab->totalPistas; i++) {
+        const char *t = textoDoInstantaneo(pool, cab->tamTextos, pistas[i].texto);
+        valido = t && pistas[i].ocorrencias > 0 && (!anterior || strcmp(anterior, t) < 0);
+        anterior = t;
+    }
+    anterior = NULL;
+    for (uint32_t i = 0; valido && i < cab->totalEvidencias; i++) {
+        const char *t = textoDoInstantaneo(pool, cab->tamTextos, evid[i].texto);
+        valido = t && evid[i].total > 0 && (!anterior || strcmp(anterior, t) < 0);
+        anterior = t;
+    }
+    // a sala salva precisa existir nesta mansão (número em pré-ordem)
+    PosicaoSala salaSalva = sessao->atual;
+    if (valido && cab->sala != SALA_NENHUMA) {
+        uint32_t indice = cab->sala;
+        valido = localizarPreordem(mansao, &salaSalva, &indice, 1);
+    }
+    if (!valido) {
+        fprintf(stderr, "%s: instantâneo inválido ou de outra mansão\n", caminho);
+        munmap(base, tam);
+        return -1;
+    }
+
+    // os registros já vêm em ordem e sem repetidas (validado acima): a árvore é ligada
+    // direto, balanceada, em O(n)
+    if (cab->totalPistas) {
+        ESTAT_ALOCACAO(ALOC_PISTAS, 1);
+        ChavePista *chaves = (ChavePista*) malloc(cab->totalPistas * sizeof(ChavePista));
+        if (!chaves) { perror("malloc"); exit(EXIT_FAILURE); }
+        for (uint32_t i = 0; i < cab->totalPistas; i++) {
+            IdTexto id = internar(pool + pistas[i].texto);
+            ChavePista c = { prefixoTexto(textoDe(id)), id, pistas[i].ocorrencias };
+            chaves[i] = c;
+            if (sessao->processo) marcarColetada(sessao, id);
+        }
+        sessao->raizPistas = mesclarChaves(sessao->raizPistas, chaves, cab->totalPistas);
+        free(chaves);
+    }
+
+    IdTexto maisProvavel = SEM_TEXTO;
+    if (cab->totalEvidencias) {
+        ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+        IdTexto *suspeitos = (IdTexto*) malloc(cab->totalEvidencias * sizeof(IdTexto));
+        if (!suspeitos) { perror("malloc"); exit(EXIT_FAILURE); }
+        for (uint32_t i = 0; i < cab->totalEvidencias; i++) {
+            suspeitos[i] = internar(pool + evid[i].texto);
+            reservarSuspeito(sessao, suspeitos[i]);
+            sessao->evidencias[suspeitos[i]] = evid[i].total;
+        }
+        // o arquivo não guarda a ordem de chegada: o mais provável recebe a primeira marca
+        // (mantém o líder nos empates) e os demais seguem a ordem alfabética
+        if (cab->maisProvavel != UINT32_MAX) maisProvavel = suspeitos[cab->maisProvavel];
+        if (maisProvavel != SEM_TEXTO) registrarEvidencia(sessao, maisProvavel);
+        for (uint32_t i = 0; i < cab->totalEvidencias; i++)
+            if (suspeitos[i] != maisProvavel) registrarEvidencia(sessao, suspeitos[i]);
+        free(suspeitos);
+    }
+    sessao->maisProvavel = maisProvavel;
+    sessao->atual = salaSalva;
+    munmap(base, tam);
+    return 0;
+}
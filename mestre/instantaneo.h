@@ -0,0 +1,42 @@
+/* instantaneo.h – instantâneo binário da sessão (.dqs) */
+#ifndef MESTRE_INSTANTANEO_H
+#define MESTRE_INSTANTANEO_H
+
+#include "sessao.h"
+
+#define SESSAO_MAGIA "DQS1"
+#define SESSAO_VERSAO 2            // 2: pistas e suspeitos gravados como texto, não como IdTexto
+
+/* Cabeçalho do instantâneo de sessão, seguido de RegistroPista[totalPistas],
+   RegistroEvidencia[totalEvidencias] (só contadores não nulos), ambos em ordem alfabética,
+   e do pool de textos ('\0' no fim de cada um). Os registros apontam para o pool, não
+   para IdTexto: os ids dependem da ordem em que cada execução internou os textos. */
+typedef struct CabecalhoSessao {
+    char magia[4];
+    uint32_t versao;
+    uint32_t sala;              // índice em pré-ordem da sala atual (SALA_NENHUMA = entrada)
+    uint32_t totalPistas;
+    uint32_t totalEvidencias;
+    uint32_t maisProvavel;      // posição em RegistroEvidencia (UINT32_MAX = nenhum)
+    uint64_t tamTextos;         // bytes do pool de textos
+} CabecalhoSessao;
+
+typedef struct RegistroPista {
+    uint32_t texto;             // offset no pool de textos
+    int32_t ocorrencias;
+} RegistroPista;
+
+typedef struct RegistroEvidencia {
+    uint32_t texto;             // offset no pool de textos
+    int32_t total;
+} RegistroEvidencia;
+
+/* salvarSessao() – grava o instantâneo da sessão numa única escrita sequencial (ao fim ou,
+   com sessao->gravarEm, pela opção (g) no meio da exploração).
+   retomarSessao() – mapeia o instantâneo e restaura a sessão (vazia) sobre a mesma mansão,
+   internando os textos gravados (vale entre execuções e layouts com outra ordem de ids);
+   recusa arquivos malformados ou cuja sala não exista nesta mansão. Retornam 0 ou -1. */
+int salvarSessao(const char *caminho, const Mansao *mansao, const Sessao *sessao);
+int retomarSessao(const char *caminho, const Mansao *mansao, Sessao *sessao);
+
+#endif
@@ -0,0 +1,202 @@
+/* lote.c – modo lote: sessões roteirizadas em threads e correções aplicadas durante o lote */
+
+#include "lote.h"
+#include "memoria.h"
+#include "textos.h"
+
+/* Lote de sessões repartido entre threads. Mansão, tabela e textos são só lidos;
+   a única escrita compartilhada é o contador atômico da próxima sessão. */
+typedef struct Lote {
+    const Mansao *mansao;
+    const TabelaHash *hash;
+    const MapaRotas *rotas;    // NULL = sessões sem voltar/dica
+    const Processo *processo;  // NULL = sem pontuação ponderada
+    char **linhas;             // uma sessão por linha ("movimentos | acusado")
+    size_t total;
+    atomic_size_t proxima;
+    int historico;             // roteiros podem desfazer ('u') e bifurcar ('b', 'a')
+    int silencioso;
+} Lote;
+
+/* Trabalhador do lote: estado e resultados privados de uma thread */
+typedef struct TrabalhadorLote {
+    Lote *lote;
+    pthread_t thread;
+    unsigned long totais[3];   // indexado por Veredito
+    unsigned long sessoes;
+} TrabalhadorLote;
+
+/* lerLinhas: carrega o arquivo inteiro e o divide em linhas terminadas em '\0' */
+static char* lerLinhas(FILE *in, char ***linhas, size_t *total) {
+    size_t tam = 0, cap = 1 << 16;
+    ESTAT_ALOCACAO(ALOC_LOTE, 1);
+    char *buf = (char*) malloc(cap);
+    if (!buf) { perror("malloc"); exit(EXIT_FAILURE); }
+    size_t n;
+    while ((n = fread(buf + tam, 1, cap - tam - 1, in)) > 0) {
+        tam += n;
+        if (cap - tam - 1 == 0) {
+            cap *= 2;
+            ESTAT_ALOCACAO(ALOC_LOTE, 1);
+            buf = (char*) realloc(buf, cap);
+            if (!buf) { perror("realloc"); exit(EXIT_FAILURE); }
+        }
+    }
+    buf[tam] = '\0';
+    size_t qtd = 0, capLinhas = 1024;
+    ESTAT_ALOCACAO(ALOC_LOTE, 1);
+    char **v = (char**) malloc(capLinhas * sizeof(char*));
+    if (!v) { perror("malloc"); exit(EXIT_FAILURE); }
+    for (char *p = buf; p < buf + tam; ) {
+        char *fim = strchr(p, '\n');
+        if (fim) *fim = '\0';
+        if (qtd == capLinhas) {
+            capLinhas *= 2;
+            ESTAT_ALOCACAO(ALOC_LOTE, 1);
+            v = (char**) realloc(v, capLinhas * sizeof(char*));
+            if (!v) { perror("realloc"); exit(EXIT_FAILURE); }
+        }
+        v[qtd++] = p;
+        p = fim ? fim + 1 : buf + tam;
+    }
+    *linhas = v;
+    *total = qtd;
+    return buf;
+}
+
+/* trabalharLote: reserva blocos de LOTE_BLOCO sessões e roda cada uma do início ao fim
+   (explorar -> coletar -> acusar); arena resetada e buffer de saída gravado por bloco */
+static void* trabalharLote(void *arg) {
+    TrabalhadorLote *t = (TrabalhadorLote*) arg;
+    Lote *lote = t->lote;
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    Saida saida = { NULL, 0, 0, lote->silencioso };
+
+    for (;;) {
+        size_t inicio = atomic_fetch_add(&lote->proxima, LOTE_BLOCO);
+        if (inicio >= lote->total) break;
+        size_t fim = inicio + LOTE_BLOCO < lote->total ? inicio + LOTE_BLOCO : lote->total;
+        for (size_t i = inicio; i < fim; i++) {
+            char *acusado;
+            char *movimentos = separarBarra(lote->linhas[i], &acusado);
+            if (movimentos[0] == '#' || (movimentos[0] == '\0' && !acusado)) continue;
+
+            Sessao sessao;
+            iniciarSessao(&sessao);
+            sessao.roteiro = movimentos;
+            sessao.saida = &saida;
+            sessao.rotas = lote->rotas;
+            sessao.processo = lote->processo;
+            if (lote->historico) ativarHistorico(&sessao);
+            explorarSalas(lote->mansao, &sessao, lote->hash);
+            apresentarPistas(&sessao);
+            apresentarPonderado(&sessao, RANKING_EXIBIDO);
+            Veredito v = julgarAcusacao(&sessao, acusado);
+            if (v != SEM_JULGAMENTO) t->totais[v]++;
+            t->sessoes++;
+            liberarSessao(&sessao);
+            arenaResetar(&arena);
+        }
+        if (saida.tam) fwrite(saida.buf, 1, saida.tam, stdout);
+        saida.tam = 0;
+    }
+    free(saida.buf);
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    liberarLeitorConcorrente();
+    return NULL;
+}
+
+/* executarLote: divide as linhas entre as threads e soma os resultados no final */
+int executarLote(const char *caminho, const Mansao *mansao, const TabelaHash *hash,
+                 const MapaRotas *rotas, const Processo *processo, int historico,
+                 int silencioso, int threads) {
+    FILE *in = strcmp(caminho, "-") == 0 ? stdin : fopen(caminho, "r");
+    if (!in) { perror(caminho); return -1; }
+    Lote lote;
+    lote.mansao = mansao;
+    lote.hash = hash;
+    lote.rotas = rotas;
+    lote.processo = processo;
+    lote.historico = historico;
+    lote.silencioso = silencioso;
+    atomic_init(&lote.proxima, 0);
+    char *conteudo = lerLinhas(in, &lote.linhas, &lote.total);
+    if (in != stdin) fclose(in);
+
+    if (threads <= 0) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = nucleos > 0 ? (int) nucleos : 1;
+    }
+    ESTAT_ALOCACAO(ALOC_LOTE, 1);
+    TrabalhadorLote *trab = (TrabalhadorLote*) calloc((size_t) threads, sizeof(TrabalhadorLote));
+    if (!trab) { perror("calloc"); exit(EXIT_FAILURE); }
+    for (int i = 0; i < threads; i++) trab[i].lote = &lote;
+    if (threads == 1) {
+        Arena *anterior = arenaAtual;
+        trabalharLote(&trab[0]);
+        usarArena(anterior);
+    } else {
+        for (int i = 0; i < threads; i++) {
+            if (pthread_create(&trab[i].thread, NULL, trabalharLote, &trab[i]) != 0) {
+                perror("pthread_create");
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (int i = 0; i < threads; i++) pthread_join(trab[i].thread, NULL);
+    }
+
+    unsigned long totais[3] = { 0, 0, 0 }, sessoes = 0;
+    for (int i = 0; i < threads; i++) {
+        for (int v = 0; v < 3; v++) totais[v] += trab[i].totais[v];
+        sessoes += trab[i].sessoes;
+    }
+    printf("%lu sessões: %lu sustentadas, %lu insuficientes, %lu infundadas\n",
+           sessoes, totais[ACUSACAO_SUSTENTADA], totais[PROVAS_INSUFICIENTES], totais[ACUSACAO_INFUNDADA]);
+    free(trab);
+    free(lote.linhas);
+    free(conteudo);
+    return 0;
+}
+
+/* aplicarCorrecoes: thread escritora; só consulta o índice de textos, nunca o altera */
+static void* aplicarCorrecoes(void *arg) {
+    Correcoes *c = (Correcoes*) arg;
+    for (size_t i = 0; i < c->total; i++) {
+        char *suspeito;
+        char *pista = separarBarra(c->linhas[i], &suspeito);
+        if (pista[0] == '#' || (pista[0] == '\0' && !suspeito)) continue;
+        IdTexto p = buscarTexto(pista), s = suspeito ? buscarTexto(suspeito) : SEM_TEXTO;
+        if (p == SEM_TEXTO || s == SEM_TEXTO) {
+            c->ignoradas++;
+            continue;
+        }
+        inserirConcorrente(c->tabela, p, s);
+        c->aplicadas++;
+    }
+    return NULL;
+}
+
+int iniciarCorrecoes(const char *caminho, TabelaConcorrente *tc, Correcoes *c) {
+    memset(c, 0, sizeof(*c));
+    FILE *in = fopen(caminho, "r");
+    if (!in) { perror(caminho); return -1; }
+    c->tabela = tc;
+    c->conteudo = lerLinhas(in, &c->linhas, &c->total);
+    fclose(in);
+    if (pthread_create(&c->thread, NULL, aplicarCorrecoes, c) != 0) {
+        perror("pthread_create");
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
+
+void concluirCorrecoes(Correcoes *c) {
+    pthread_join(c->thread, NULL);
+    printf("%lu correções aplicadas durante o lote", c->aplicadas);
+    if (c->ignoradas) printf(" (%lu ignoradas: texto desconhecido)", c->ignoradas);
+    printf("\n");
+    free(c->linhas);
+    free(c->conteudo);
+}
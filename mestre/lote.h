@@ -0,0 +1,38 @@
+/* lote.h – modo lote e correções concorrentes */
+#ifndef MESTRE_LOTE_H
+#define MESTRE_LOTE_H
+
+#include "exploracao.h"
+#include "concorrente.h"
+
+#define LOTE_BLOCO 256               // sessões que uma thread reserva (e grava) de uma vez
+
+/* Correções aplicadas por uma thread escritora enquanto o lote roda ("pista | suspeito"
+   por linha, textos já conhecidos do mapa) */
+typedef struct Correcoes {
+    TabelaConcorrente *tabela;
+    char **linhas;
+    size_t total;
+    char *conteudo;
+    unsigned long aplicadas, ignoradas;
+    pthread_t thread;
+} Correcoes;
+
+/* executarLote() – reproduz sessões "movimentos | acusado", uma por linha, em 'threads'
+   trabalhadores (0 = um por núcleo). Cada thread tem arena, buffer e contadores próprios;
+   a saída de cada sessão sai inteira, mas a ordem entre sessões não é garantida com
+   mais de uma thread. Com 'rotas', os roteiros podem usar 'v' e 'r' (índice só lido); com
+   'processo' (compilado), cada sessão mostra também a pontuação ponderada; com
+   'historico', os roteiros podem usar 'u', 'b' e 'a'. Retorna 0 ou -1 se o arquivo não abrir. */
+int executarLote(const char *caminho, const Mansao *mansao, const TabelaHash *hash,
+                 const MapaRotas *rotas, const Processo *processo, int historico,
+                 int silencioso, int threads);
+
+/* iniciarCorrecoes() – lê o arquivo de correções e dispara a thread que as aplica em 'tc'.
+   Pistas ou suspeitos que ainda não foram internados são ignorados (internar não é seguro
+   com sessões em andamento). concluirCorrecoes() espera a thread e informa o resultado.
+   iniciarCorrecoes retorna 0 ou -1 se o arquivo não abrir. */
+int iniciarCorrecoes(const char *caminho, TabelaConcorrente *tc, Correcoes *c);
+void concluirCorrecoes(Correcoes *c);
+
+#endif
@@ -0,0 +1,289 @@
+/* mansao.c – mansão: a fixa do capítulo, salas por ponteiros, layout plano e percursos que
+   valem em qualquer layout */
+
+#include "mansao.h"
+#include "associacoes.h"
+#include "memoria.h"
+#include "paginada.h"
+#include "textos.h"
+
+/* criarSala: aloca e inicializa uma sala (cômodo) dinamicamente */
+Sala* criarSala(const char *nome, const char *pista) {
+    Sala *s = (Sala*) alocarNo(sizeof(Sala), ALOC_SALAS);
+    s->nome = internar(nome);
+    s->pista = internar(pista);
+    s->esquerda = s->direita = NULL;
+    return s;
+}
+
+/* navegação independente de layout (ponteiros, índices ou sob demanda) */
+PosicaoSala posicaoInicial(const Mansao *m) {
+    PosicaoSala p = { NULL, SALA_NENHUMA };
+    if (m->paginada) p.indice = m->paginada->cab.totalSalas ? m->paginada->cab.raiz : SALA_NENHUMA;
+    else if (m->plana) p.indice = m->plana->total ? m->plana->raiz : SALA_NENHUMA;
+    else p.sala = m->raizArvore;
+    return p;
+}
+
+int posicaoValida(const Mansao *m, PosicaoSala p) {
+    if (m->paginada) return p.indice < m->paginada->cab.totalSalas;
+    return m->plana ? p.indice < m->plana->total : p.sala != NULL;
+}
+
+/* textoPlano: índice de texto do layout plano -> string (do pool do arquivo ou interna) */
+static const char* textoPlano(const MansaoPlana *mp, uint32_t t) {
+    if (!mp->offTextos) return textoDe(t);
+    return t < mp->totalTextos && mp->offTextos[t] < mp->tamPool ? mp->pool + mp->offTextos[t] : "";
+}
+
+/* nomeDaPosicao: na mansão paginada o texto vive no slot do cache (válido até a sala sair) */
+const char* nomeDaPosicao(const Mansao *m, PosicaoSala p) {
+    if (m->paginada) return salaResidente(m->paginada, p.indice)->nome;
+    return m->plana ? textoPlano(m->plana, m->plana->nomes[p.indice]) : textoDe(p.sala->nome);
+}
+
+IdTexto pistaDaPosicao(const Mansao *m, PosicaoSala p) {
+    if (m->paginada) return salaResidente(m->paginada, p.indice)->pista;
+    if (!m->plana) return p.sala->pista;
+    uint32_t t = m->plana->salas[p.indice].pista;
+    if (!m->plana->ids) return t;
+    return t < m->plana->totalIds ? m->plana->ids[t] : SEM_TEXTO;
+}
+
+PosicaoSala filhoDaPosicao(const Mansao *m, PosicaoSala p, int direita) {
+    PosicaoSala f = { NULL, SALA_NENHUMA };
+    if (m->paginada) {
+        const SalaPlana *sp = &salaResidente(m->paginada, p.indice)->registro;
+        f.indice = direita ? sp->direita : sp->esquerda;
+    } else if (m->plana) {
+        const SalaPlana *sp = &m->plana->salas[p.indice];
+        f.indice = direita ? sp->direita : sp->esquerda;   // fora do intervalo = inválido
+    } else {
+        f.sala = direita ? p.sala->direita : p.sala->esquerda;
+    }
+    return f;
+}
+
+/* ------------------ Layout plano ------------------ */
+
+/* planificarMansao: numera as salas na ordem pedida com uma pilha (pré-ordem) ou fila
+   (largura) explícita, e grava em cada pai o índice dos filhos */
+void planificarMansao(const Sala *raiz, int ordem, MansaoPlana *plana) {
+    memset(plana, 0, sizeof(*plana));
+    plana->raiz = 0;
+    Mansao arvore = { (Sala*) raiz, NULL, NULL };
+    uint32_t total = contarSalas(&arvore);
+    if (total == 0) return;
+
+    ESTAT_ALOCACAO(ALOC_MANSAO, 4);
+    SalaPlana *salas = (SalaPlana*) malloc(total * sizeof(SalaPlana));
+    uint32_t *nomes = (uint32_t*) malloc(total * sizeof(uint32_t));
+    // pendentes: sala a numerar + campo do pai que recebe o índice dela
+    const Sala **pend = (const Sala**) malloc(total * sizeof(Sala*));
+    uint32_t **campoPai = (uint32_t**) malloc(total * sizeof(uint32_t*));
+    if (!salas || !nomes || !pend || !campoPai) { perror("malloc"); exit(EXIT_FAILURE); }
+
+    uint32_t inicio = 0, fim = 0, prox = 0;   // fila (largura) ou pilha (pré-ordem, usa só 'fim')
+    pend[fim] = raiz; campoPai[fim++] = NULL;
+    while (fim > inicio) {
+        const Sala *s;
+        uint32_t *campo;
+        if (ordem == ORDEM_LARGURA) { s = pend[inicio]; campo = campoPai[inicio++]; }
+        else { s = pend[--fim]; campo = campoPai[fim]; }
+
+        uint32_t idx = prox++;
+        if (campo) *campo = idx;
+        salas[idx].esquerda = salas[idx].direita = SALA_NENHUMA;
+        salas[idx].pista = s->pista;
+        nomes[idx] = s->nome;
+        if (ordem == ORDEM_LARGURA) {
+            if (s->esquerda) { pend[fim] = s->esquerda; campoPai[fim++] = &salas[idx].esquerda; }
+            if (s->direita) { pend[fim] = s->direita; campoPai[fim++] = &salas[idx].direita; }
+        } else {
+            // direita empilhada primeiro: a esquerda é visitada logo em seguida
+            if (s->direita) { pend[fim] = s->direita; campoPai[fim++] = &salas[idx].direita; }
+            if (s->esquerda) { pend[fim] = s->esquerda; campoPai[fim++] = &salas[idx].esquerda; }
+        }
+    }
+    free(pend);
+    free(campoPai);
+    plana->salas = salas;
+    plana->nomes = nomes;
+    plana->total = total;
+}
+
+void liberarMansaoPlana(MansaoPlana *plana) {
+    free((void*) plana->salas);
+    free((void*) plana->nomes);
+    memset(plana, 0, sizeof(*plana));
+}
+
+/* cicloNaPaginada: o mapa paginado não é validado na abertura (só o cabeçalho é lido); um
+   percurso que passe do total de salas do cabeçalho encontrou um ciclo */
+static void cicloNaPaginada(const Mansao *m, uint64_t visitadas) {
+    if (m->paginada && visitadas > m->paginada->cab.totalSalas) {
+        fprintf(stderr, "mapa paginado: as salas não formam uma árvore\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* percorrerMansao: DFS iterativa (pilha explícita, sem recursão) que conta salas e
+   mede a profundidade máxima em qualquer layout */
+static uint32_t percorrerMansao(const Mansao *m, uint32_t *profundidade) {
+    PosicaoSala *pilha = NULL;
+    uint32_t *niveis = NULL;
+    size_t topo = 0, cap = 0;
+    uint32_t total = 0, maxNivel = 0;
+    PosicaoSala p = posicaoInicial(m);
+    if (posicaoValida(m, p)) {
+        cap = 64;
+        ESTAT_ALOCACAO(ALOC_MANSAO, 2);
+        pilha = (PosicaoSala*) malloc(cap * sizeof(PosicaoSala));
+        niveis = (uint32_t*) malloc(cap * sizeof(uint32_t));
+        if (!pilha || !niveis) { perror("malloc"); exit(EXIT_FAILURE); }
+        pilha[topo] = p; niveis[topo++] = 1;
+    }
+    while (topo > 0) {
+        PosicaoSala atual = pilha[--topo];
+        uint32_t nivel = niveis[topo];
+        total++;
+        cicloNaPaginada(m, total);
+        if (nivel > maxNivel) maxNivel = nivel;
+        for (int lado = 0; lado < 2; lado++) {
+            PosicaoSala f = filhoDaPosicao(m, atual, lado);
+            if (!posicaoValida(m, f)) continue;
+            if (topo == cap) {
+                cap *= 2;
+                ESTAT_ALOCACAO(ALOC_MANSAO, 2);
+                pilha = (PosicaoSala*) realloc(pilha, cap * sizeof(PosicaoSala));
+                niveis = (uint32_t*) realloc(niveis, cap * sizeof(uint32_t));
+                if (!pilha || !niveis) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            pilha[topo] = f; niveis[topo++] = nivel + 1;
+        }
+    }
+    free(pilha);
+    free(niveis);
+    if (profundidade) *profundidade = maxNivel;
+    return total;
+}
+
+uint32_t contarSalas(const Mansao *mansao) {
+    if (mansao->paginada) return mansao->paginada->cab.totalSalas;   // sem ler o mapa todo
+    return percorrerMansao(mansao, NULL);
+}
+
+uint32_t profundidadeMansao(const Mansao *mansao) {
+    uint32_t prof;
+    percorrerMansao(mansao, &prof);
+    return prof;
+}
+
+/* memoriaMansao: bytes da estrutura de navegação (sem os textos, que são compartilhados) */
+size_t memoriaMansao(const Mansao *mansao) {
+    if (mansao->paginada) return (size_t) mansao->paginada->capacidade * sizeof(SalaPaginada);
+    if (mansao->plana) return (size_t) mansao->plana->total * (sizeof(SalaPlana) + sizeof(uint32_t));
+    return (size_t) contarSalas(mansao) * sizeof(Sala);
+}
+
+/* localizarPreordem: percorre a mansão em pré-ordem (esquerda antes da direita) até achar
+   a posição (*indice = número dela) ou, com porIndice, o número (*pos = posição dele).
+   A numeração independe do layout, então o instantâneo vale para árvore e plano. */
+int localizarPreordem(const Mansao *m, PosicaoSala *pos, uint32_t *indice, int porIndice) {
+    size_t topo = 0, cap = 64;
+    PosicaoSala *pilha = (PosicaoSala*) malloc(cap * sizeof(PosicaoSala));
+    if (!pilha) { perror("malloc"); exit(EXIT_FAILURE); }
+    PosicaoSala p = posicaoInicial(m);
+    if (posicaoValida(m, p)) pilha[topo++] = p;
+    uint32_t numero = 0;
+    int achou = 0;
+    while (topo > 0 && !achou) {
+        PosicaoSala atual = pilha[--topo];
+        if (porIndice ? numero == *indice
+                      : (m->raizArvore ? atual.sala == pos->sala : atual.indice == pos->indice)) {
+            if (porIndice) *pos = atual;
+            else *indice = numero;
+            achou = 1;
+            break;
+        }
+        numero++;
+        cicloNaPaginada(m, numero);
+        if (topo + 2 > cap) {
+            cap *= 2;
+            pilha = (PosicaoSala*) realloc(pilha, cap * sizeof(PosicaoSala));
+            if (!pilha) { perror("realloc"); exit(EXIT_FAILURE); }
+        }
+        for (int lado = 1; lado >= 0; lado--) {   // direita empilhada primeiro
+            PosicaoSala f = filhoDaPosicao(m, atual, lado);
+            if (posicaoValida(m, f)) pilha[topo++] = f;
+        }
+    }
+    free(pilha);
+    return achou;
+}
+
+/* liberarSalas: libera árvore da mansão sem pilha: enquanto houver filho à esquerda,
+   gira-o para cima; sem ele, a raiz sai e a direita assume (O(n), qualquer formato) */
+void liberarSalas(Sala *raiz) {
+    while (raiz) {
+        if (raiz->esquerda) {
+            Sala *e = raiz->esquerda;
+            raiz->esquerda = e->direita;
+            e->direita = raiz;
+            raiz = e;
+        } else {
+            Sala *d = raiz->direita;
+            free(raiz);
+            raiz = d;
+        }
+    }
+}
+
+/* montarMansaoFixa: mansão, associações e (com 'processo') implicações do capítulo final,
+   fixas no código */
+Sala* montarMansaoFixa(TabelaHash *hash, Processo *processo) {
+    /* --- Montagem fixa da mansão (árvore binária) --- */
+    Sala *hall = criarSala("Hall de Entrada", "Pegada de lama");
+    Sala *salaEstar = criarSala("Sala de Estar", "Lenço rasgado");
+    Sala *cozinha = criarSala("Cozinha", "Copo quebrado");
+    Sala *biblioteca = criarSala("Biblioteca", "Diário antigo");
+    Sala *jardim = criarSala("Jardim", "Chave enferrujada");
+    Sala *despensa = criarSala("Despensa", "Luvas sujas");
+    Sala *garagem = criarSala("Garagem", "Pneu com marca estranha");
+    Sala *porao = criarSala("Porão", "Marca de tinta vermelha");
+
+    // ligações
+    hall->esquerda = salaEstar; hall->direita = cozinha;
+    salaEstar->esquerda = biblioteca; salaEstar->direita = jardim;
+    cozinha->esquerda = despensa; cozinha->direita = garagem;
+    biblioteca->esquerda = porao; // exemplo de profundidade extra
+
+    /* --- Associações pista -> suspeito e implicações do processo ("implica"): geradas de
+           mapas/mansao_enigma.txt em associacoes_fixas.h; sem o arquivo, as associações
+           entram na tabela dinâmica e o processo fica só com elas --- */
+    static const char *const associacoes[][2] = {
+        { "Pegada de lama", "Sr. Verdes" },
+        { "Lenço rasgado", "Sra. Marinho" },
+        { "Copo quebrado", "Sra. Marinho" },
+        { "Diário antigo", "Sr. Rocha" },
+        { "Chave enferrujada", "Sr. Verdes" },
+        { "Luvas sujas", "Sr. Rocha" },
+        { "Pneu com marca estranha", "Motorista" },
+        { "Marca de tinta vermelha", "Pintor" },
+    };
+    const size_t totalAssociacoes = sizeof(associacoes) / sizeof(associacoes[0]);
+    // associações antes do processo: os textos são internados na mesma ordem com e sem
+    // --ponderado, e um instantâneo (.dqs) gravado num modo é retomado no outro
+    if (usarAssociacoesFixas(hash) != 0)
+        for (size_t i = 0; i < totalAssociacoes; i++) inserirNaHash(hash, associacoes[i][0], associacoes[i][1]);
+    if (processo) {
+        for (size_t i = 0; i < totalAssociacoes; i++)
+            registrarImplicacao(processo, internar(associacoes[i][0]), internar(associacoes[i][1]), PESO_ASSOCIACAO);
+#if defined(COM_ASSOCIACOES_FIXAS) && TOTAL_IMPLICACOES_FIXAS > 0
+        for (uint32_t i = 0; i < TOTAL_IMPLICACOES_FIXAS; i++)
+            registrarImplicacao(processo, internar(IMPLICACOES_FIXAS[i].pista), internar(IMPLICACOES_FIXAS[i].suspeito),
+                                IMPLICACOES_FIXAS[i].peso);
+#endif
+    }
+    return hall;
+}
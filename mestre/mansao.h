@@ -0,0 +1,95 @@
+/* mansao.h – a mansão em qualquer layout e a navegação por ela */
+#ifndef MESTRE_MANSAO_H
+#define MESTRE_MANSAO_H
+
+#include "processo.h"
+
+#define SALA_NENHUMA UINT32_MAX      // índice de filho ausente no layout plano
+#define ORDEM_PREORDEM 0             // planificação em profundidade: caminho à esquerda contíguo
+#define ORDEM_LARGURA 1              // planificação por níveis (= Eytzinger numa árvore completa)
+
+/* definida em paginada.h */
+typedef struct MansaoPaginada MansaoPaginada;
+
+/* Nó da árvore da mansão (cada cômodo) */
+typedef struct Sala {
+    IdTexto nome;
+    IdTexto pista;   // SEM_TEXTO se não tiver pista
+    struct Sala *esquerda;
+    struct Sala *direita;
+} Sala;
+
+/* Registro de navegação de uma sala no layout plano (igual ao do arquivo binário) */
+typedef struct SalaPlana {
+    uint32_t esquerda;   // índice do filho (SALA_NENHUMA se não houver)
+    uint32_t direita;
+    uint32_t pista;      // índice de texto da pista (0 = sem pista)
+} SalaPlana;
+
+/* Mansão em vetores contíguos: navegação separada dos nomes de exibição.
+   No mapa binário os índices de texto apontam para o pool do arquivo; só os
+   textos de pistas/suspeitos (os primeiros 'totalIds') ganham IdTexto na carga. */
+typedef struct MansaoPlana {
+    const SalaPlana *salas;
+    const uint32_t *nomes;      // por sala: índice de texto do nome
+    uint32_t total;
+    uint32_t raiz;
+    const uint64_t *offTextos;  // índice de texto -> offset no pool (NULL = índices são IdTexto)
+    const char *pool;
+    uint64_t tamPool;
+    uint32_t totalTextos;
+    const IdTexto *ids;         // índice de texto (< totalIds) -> IdTexto
+    uint32_t totalIds;
+} MansaoPlana;
+
+/* Mansão em qualquer um dos layouts: árvore de Sala (ponteiros), plana (índices) ou
+   paginada (índices do arquivo, salas carregadas sob demanda) */
+typedef struct Mansao {
+    Sala *raizArvore;           // layout por ponteiros (NULL se plana)
+    const MansaoPlana *plana;   // layout plano (NULL se árvore)
+    MansaoPaginada *paginada;   // mansão paginada (NULL nos outros layouts)
+} Mansao;
+
+/* Posição do jogador: ponteiro ou índice, conforme o layout */
+typedef struct PosicaoSala {
+    const Sala *sala;
+    uint32_t indice;
+} PosicaoSala;
+
+/* criarSala() – cria dinamicamente um cômodo com ou sem pista. */
+Sala* criarSala(const char *nome, const char *pista);
+
+/* planificarMansao() – copia a árvore de Sala para o layout plano na ordem pedida
+   (ORDEM_PREORDEM ou ORDEM_LARGURA). Liberar com liberarMansaoPlana(). */
+void planificarMansao(const Sala *raiz, int ordem, MansaoPlana *plana);
+void liberarMansaoPlana(MansaoPlana *plana);
+
+/* contarSalas() / profundidadeMansao() / memoriaMansao() – percursos iterativos
+   que funcionam em qualquer layout. */
+uint32_t contarSalas(const Mansao *mansao);
+uint32_t profundidadeMansao(const Mansao *mansao);
+size_t memoriaMansao(const Mansao *mansao);
+
+/* montarMansaoFixa() – a mansão do capítulo final, fixa no código, com as associações em
+   'hash' (pelo hash perfeito gerado, se houver) e, com 'processo', as implicações. */
+Sala* montarMansaoFixa(TabelaHash *hash, Processo *processo);
+
+/* liberarSalas() – libera a árvore de salas (quando não veio de uma arena). */
+void liberarSalas(Sala *raiz);
+
+/* Navegação independente de layout (ponteiros, índices ou sob demanda).
+   posicaoInicial() – a entrada (inválida se a mansão for vazia). posicaoValida() – a
+   posição aponta para uma sala. nomeDaPosicao() / pistaDaPosicao() – nome e pista da sala
+   (na mansão paginada o nome vive no cache: vale até a sala sair dele). filhoDaPosicao() –
+   esquerda ou direita (inválida se não houver caminho). */
+PosicaoSala posicaoInicial(const Mansao *m);
+int posicaoValida(const Mansao *m, PosicaoSala p);
+const char* nomeDaPosicao(const Mansao *m, PosicaoSala p);
+IdTexto pistaDaPosicao(const Mansao *m, PosicaoSala p);
+PosicaoSala filhoDaPosicao(const Mansao *m, PosicaoSala p, int direita);
+
+/* localizarPreordem() – número em pré-ordem da posição *pos ou, com porIndice, a posição
+   do número *indice. A numeração independe do layout. Retorna 0 se não achar. */
+int localizarPreordem(const Mansao *m, PosicaoSala *pos, uint32_t *indice, int porIndice);
+
+#endif
@@ -0,0 +1,514 @@
+/* mapa.c – mapa binário (.dqm): conversão do texto, hash perfeito gerado e carga com mmap */
+
+#include "mapa.h"
+#include "associacoes.h"
+#include "hash.h"
+#include "textos.h"
+
+/* implicacoesDoMapa / offImplicacoes: a seção da versão 3 vem logo após as associações
+   (antes dela o campo era reservado e gravado como 0) */
+uint32_t implicacoesDoMapa(const CabecalhoMapa *cab) {
+    return cab->versao >= 3 ? cab->totalImplicacoes : 0;
+}
+
+uint64_t offImplicacoes(const CabecalhoMapa *cab) {
+    return cab->offAssociacoes + (uint64_t) cab->totalAssociacoes * sizeof(AssociacaoMapa);
+}
+
+/* ------------------ Mapa binário ------------------ */
+
+/* lerIndiceSala: número de sala ou '-' (SALA_NENHUMA) */
+static int lerIndiceSala(const char *tok, uint32_t total, uint32_t *indice) {
+    if (strcmp(tok, "-") == 0) { *indice = SALA_NENHUMA; return 0; }
+    char *fim;
+    unsigned long v = strtoul(tok, &fim, 10);
+    if (*fim != '\0' || v >= total) return -1;
+    *indice = (uint32_t) v;
+    return 0;
+}
+
+/* validarArvoreSalas: as ligações formam uma árvore a partir de 'raiz' – nenhuma sala com
+   dois pais, nenhum caminho de volta à raiz e todas alcançáveis (logo, cada uma uma vez).
+   Percorrer um mapa com ciclo não terminaria; por isso a forma é checada na conversão e na
+   carga, e não a cada passo. Retorna 0 ou -1. */
+static int validarArvoreSalas(const SalaPlana *salas, uint32_t total, uint32_t raiz) {
+    if (raiz >= total) return -1;
+    ESTAT_ALOCACAO(ALOC_MAPA, 2);
+    uint8_t *temPai = (uint8_t*) calloc(total, 1);
+    uint32_t *pilha = (uint32_t*) malloc(total * sizeof(uint32_t));
+    if (!temPai || !pilha) { perror("malloc"); exit(EXIT_FAILURE); }
+    int valida = 1;
+    for (uint32_t i = 0; valida && i < total; i++) {
+        uint32_t filhos[2] = { salas[i].esquerda, salas[i].direita };
+        for (int lado = 0; valida && lado < 2; lado++) {
+            uint32_t f = filhos[lado];
+            if (f == SALA_NENHUMA) continue;
+            if (f >= total || f == raiz || temPai[f]) valida = 0;
+            else temPai[f] = 1;
+        }
+    }
+    if (valida) {
+        // com um pai por sala e a raiz sem pai, cada sala entra na pilha no máximo uma vez
+        uint32_t topo = 0, alcancadas = 0;
+        pilha[topo++] = raiz;
+        while (topo > 0) {
+            const SalaPlana *s = &salas[pilha[--topo]];
+            alcancadas++;
+            if (s->esquerda != SALA_NENHUMA) pilha[topo++] = s->esquerda;
+            if (s->direita != SALA_NENHUMA) pilha[topo++] = s->direita;
+        }
+        valida = alcancadas == total;
+    }
+    free(temPai);
+    free(pilha);
+    return valida ? 0 : -1;
+}
+
+/* completarAlinhamento: zeros até o próximo múltiplo de 8 após 'tam' bytes */
+static int completarAlinhamento(FILE *f, uint64_t tam) {
+    static const char zeros[8] = {0};
+    size_t pad = (size_t) ((8 - tam % 8) % 8);
+    return pad && fwrite(zeros, 1, pad, f) != pad ? -1 : 0;
+}
+
+/* escreverAlinhado: grava um bloco e completa até múltiplo de 8 */
+static int escreverAlinhado(FILE *f, const void *dados, size_t tam) {
+    if (tam && fwrite(dados, 1, tam, f) != tam) return -1;
+    return completarAlinhamento(f, tam);
+}
+
+/* lerImplica: campos de "implica <pista> | <suspeito> | <peso>" (sem o "implica "), já
+   internados; peso de 0 a PESO_MAXIMO. Retorna 0 ou -1 se a linha for inválida. */
+static int lerImplica(char *campos, ImplicacaoMapa *im) {
+    char *resto, *textoPeso = NULL, *fim = NULL;
+    char *pista = separarBarra(campos, &resto);
+    char *suspeito = resto ? separarBarra(resto, &textoPeso) : NULL;
+    unsigned long peso = textoPeso ? strtoul(textoPeso, &fim, 10) : 0;
+    if (!suspeito || !pista[0] || !suspeito[0] || !textoPeso || !textoPeso[0] || *fim != '\0' ||
+        peso > PESO_MAXIMO) return -1;
+    im->pista = internar(pista);
+    im->suspeito = internar(suspeito);
+    im->peso = (uint32_t) peso;
+    return 0;
+}
+
+/* compararAssociacoes: ordem do vetor de associações no arquivo (por índice da pista) */
+static int compararAssociacoes(const void *a, const void *b) {
+    uint32_t x = ((const AssociacaoMapa*) a)->pista, y = ((const AssociacaoMapa*) b)->pista;
+    return (x > y) - (x < y);
+}
+
+/* converterMapaTexto: lê a descrição, numera os textos (pistas/suspeitos primeiro)
+   e grava as seções do arquivo em uma única passada sequencial */
+int converterMapaTexto(const char *entrada, const char *saida) {
+    FILE *in = fopen(entrada, "r");
+    if (!in) { perror(entrada); return -1; }
+
+    // salas e associações com ids internos; renumerados para o arquivo no final
+    SalaPlana *salas = NULL; IdTexto *nomes = NULL; uint32_t totalSalas = 0, capSalas = 0;
+    AssociacaoMapa *assoc = NULL; uint32_t totalAssoc = 0, capAssoc = 0;
+    ImplicacaoMapa *impl = NULL; uint32_t totalImpl = 0, capImpl = 0;
+    char linha[MAX_LINHA_MAPA];
+    unsigned long numLinha = 0;
+    int erro = 0;
+
+    while (!erro && fgets(linha, sizeof(linha), in)) {
+        numLinha++;
+        char *l = aparar(linha), *resto;
+        if (l[0] == '\0' || l[0] == '#') continue;
+        if (strncmp(l, "sala ", 5) == 0) {
+            if (totalSalas == capSalas) {
+                capSalas = capSalas ? capSalas * 2 : 64;
+                salas = (SalaPlana*) realloc(salas, capSalas * sizeof(SalaPlana));
+                nomes = (IdTexto*) realloc(nomes, capSalas * sizeof(IdTexto));
+                if (!salas || !nomes) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            char *nome = separarBarra(l + 5, &resto);
+            SalaPlana sp = { SALA_NENHUMA, SALA_NENHUMA, internar(resto) };
+            salas[totalSalas] = sp;
+            nomes[totalSalas++] = internar(nome);
+        } else if (strncmp(l, "liga ", 5) == 0) {
+            char pai[32], esq[32], dir[32];
+            uint32_t ip, ie, id;
+            if (sscanf(l + 5, "%31s %31s %31s", pai, esq, dir) != 3 ||
+                lerIndiceSala(pai, totalSalas, &ip) || ip == SALA_NENHUMA ||
+                lerIndiceSala(esq, totalSalas, &ie) || lerIndiceSala(dir, totalSalas, &id)) {
+                erro = 1;
+            } else {
+                salas[ip].esquerda = ie;
+                salas[ip].direita = id;
+            }
+        } else if (strncmp(l, "associa ", 8) == 0) {
+            char *pista = separarBarra(l + 8, &resto);
+            if (!resto || !pista[0] || !resto[0]) { erro = 1; continue; }
+            if (totalAssoc == capAssoc) {
+                capAssoc = capAssoc ? capAssoc * 2 : 64;
+                assoc = (AssociacaoMapa*) realloc(assoc, capAssoc * sizeof(AssociacaoMapa));
+                if (!assoc) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            AssociacaoMapa a = { internar(pista), internar(resto) };
+            assoc[totalAssoc++] = a;
+        } else if (strncmp(l, "implica ", 8) == 0) {
+            ImplicacaoMapa im;
+            if (lerImplica(l + 8, &im) != 0) { erro = 1; continue; }
+            if (totalImpl == capImpl) {
+                capImpl = capImpl ? capImpl * 2 : 64;
+                impl = (ImplicacaoMapa*) realloc(impl, capImpl * sizeof(ImplicacaoMapa));
+                if (!impl) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            impl[totalImpl++] = im;
+        } else {
+            erro = 1;
+        }
+    }
+    fclose(in);
+    if (erro || totalSalas == 0) {
+        fprintf(stderr, "%s:%lu: linha inválida ou mapa vazio\n", entrada, numLinha);
+        free(salas); free(nomes); free(assoc); free(impl);
+        return -1;
+    }
+    if (validarArvoreSalas(salas, totalSalas, 0) != 0) {
+        fprintf(stderr, "%s: as ligações não formam uma árvore a partir da sala 0 "
+                        "(sala com dois pais, ciclo ou sala inalcançável)\n", entrada);
+        free(salas); free(nomes); free(assoc); free(impl);
+        return -1;
+    }
+
+    // numeração do arquivo: 0 = "", depois pistas/suspeitos, depois os demais textos
+    uint32_t totalTextos = textosGlobais.total;
+    uint32_t *novoIndice = (uint32_t*) calloc(totalTextos, sizeof(uint32_t));
+    IdTexto *ordem = (IdTexto*) malloc(totalTextos * sizeof(IdTexto));
+    if (!novoIndice || !ordem) { perror("malloc"); exit(EXIT_FAILURE); }
+    uint32_t prox = 1;
+    ordem[0] = SEM_TEXTO;
+#define NUMERAR(id) do { if ((id) != SEM_TEXTO && !novoIndice[id]) { novoIndice[id] = prox; ordem[prox++] = (id); } } while (0)
+    for (uint32_t i = 0; i < totalSalas; i++) NUMERAR(salas[i].pista);
+    for (uint32_t i = 0; i < totalAssoc; i++) { NUMERAR(assoc[i].pista); NUMERAR(assoc[i].suspeito); }
+    for (uint32_t i = 0; i < totalImpl; i++) { NUMERAR(impl[i].pista); NUMERAR(impl[i].suspeito); }
+    uint32_t totalChave = prox;
+    for (uint32_t i = 0; i < totalSalas; i++) NUMERAR(nomes[i]);
+#undef NUMERAR
+    totalTextos = prox;
+
+    for (uint32_t i = 0; i < totalSalas; i++) {
+        salas[i].pista = novoIndice[salas[i].pista];
+        nomes[i] = novoIndice[nomes[i]];
+    }
+    for (uint32_t i = 0; i < totalAssoc; i++) {
+        assoc[i].pista = novoIndice[assoc[i].pista];
+        assoc[i].suspeito = novoIndice[assoc[i].suspeito];
+    }
+    for (uint32_t i = 0; i < totalImpl; i++) {
+        impl[i].pista = novoIndice[impl[i].pista];
+        impl[i].suspeito = novoIndice[impl[i].suspeito];
+    }
+    // versão 2: uma associação por pista (a última, como em inserirNaHash), ordenadas por
+    // pista para a busca binária da mansão paginada
+    uint32_t livre = totalAssoc;
+    memset(novoIndice, 0, totalTextos * sizeof(uint32_t));   // reaproveitado como "já vista"
+    for (uint32_t i = totalAssoc; i-- > 0; ) {
+        if (novoIndice[assoc[i].pista]) continue;
+        novoIndice[assoc[i].pista] = 1;
+        assoc[--livre] = assoc[i];   // compacta no fim: livre > i, nunca pisa numa não lida
+    }
+    memmove(assoc, assoc + livre, (totalAssoc - livre) * sizeof(AssociacaoMapa));
+    totalAssoc -= livre;
+    qsort(assoc, totalAssoc, sizeof(AssociacaoMapa), compararAssociacoes);
+
+    uint64_t *offTextos = (uint64_t*) malloc(totalTextos * sizeof(uint64_t));
+    if (!offTextos) { perror("malloc"); exit(EXIT_FAILURE); }
+    uint64_t tamPool = 0;
+    for (uint32_t i = 0; i < totalTextos; i++) {
+        offTextos[i] = tamPool;
+        tamPool += strlen(textoDe(ordem[i])) + 1;
+    }
+
+    CabecalhoMapa cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, MAPA_MAGIA, 4);
+    cab.versao = MAPA_VERSAO;
+    cab.totalSalas = totalSalas;
+    cab.raiz = 0;
+    cab.totalTextos = totalTextos;
+    cab.totalTextosChave = totalChave;
+    cab.totalAssociacoes = totalAssoc;
+    cab.totalImplicacoes = totalImpl;
+#define ALINHAR8(x) (((x) + 7) & ~(uint64_t) 7)
+    cab.offSalas = ALINHAR8(sizeof(CabecalhoMapa));
+    cab.offNomes = cab.offSalas + ALINHAR8((uint64_t) totalSalas * sizeof(SalaPlana));
+    cab.offTextos = cab.offNomes + ALINHAR8((uint64_t) totalSalas * sizeof(uint32_t));
+    cab.offPool = cab.offTextos + (uint64_t) totalTextos * sizeof(uint64_t);
+    cab.tamPool = tamPool;
+    cab.offAssociacoes = cab.offPool + ALINHAR8(tamPool);
+#undef ALINHAR8
+
+    FILE *out = fopen(saida, "wb");
+    if (!out) { perror(saida); erro = 1; }
+    if (!erro) {
+        erro = escreverAlinhado(out, &cab, sizeof(cab)) ||
+               escreverAlinhado(out, salas, totalSalas * sizeof(SalaPlana)) ||
+               escreverAlinhado(out, nomes, totalSalas * sizeof(uint32_t)) ||
+               escreverAlinhado(out, offTextos, totalTextos * sizeof(uint64_t));
+        for (uint32_t i = 0; !erro && i < totalTextos; i++) {
+            const char *t = textoDe(ordem[i]);
+            if (fwrite(t, 1, strlen(t) + 1, out) != strlen(t) + 1) erro = 1;
+        }
+        erro = erro || completarAlinhamento(out, tamPool) ||
+               escreverAlinhado(out, assoc, totalAssoc * sizeof(AssociacaoMapa)) ||
+               escreverAlinhado(out, impl, totalImpl * sizeof(ImplicacaoMapa));
+        if (fclose(out) != 0) erro = 1;
+        if (erro) perror(saida);
+    }
+    free(salas); free(nomes); free(assoc); free(impl);
+    free(novoIndice); free(ordem); free(offTextos);
+    return erro ? -1 : 0;
+}
+
+/* escreverLiteralC: texto como literal C (aspas, barras e controles escapados) */
+static void escreverLiteralC(FILE *f, const char *texto) {
+    fputc('"', f);
+    for (const unsigned char *c = (const unsigned char*) texto; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(f, "\\%c", *c);
+        else if (*c < 0x20 || *c == 0x7F) fprintf(f, "\\%03o", *c);
+        else fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+/* compararGrupos: maiores primeiro (tamanho nos 32 bits altos, grupo nos baixos) */
+static int compararGrupos(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/* gerarHashPerfeito: hash-and-displace. As chaves são divididas em grupos pelo hash e,
+   do maior grupo para o menor, cada um recebe o primeiro deslocamento que põe todas as
+   suas chaves em slots ainda livres. Com tantos slots quanto chaves, o hash é mínimo. */
+int gerarHashPerfeito(const char *entrada, const char *saida) {
+    FILE *in = fopen(entrada, "r");
+    if (!in) { perror(entrada); return -1; }
+
+    // pista -> índice + 1 na tabela dinâmica; pista repetida substitui o suspeito
+    TabelaHash indice;
+    inicializarHash(&indice);
+    IdTexto *pistas = NULL, *suspeitos = NULL;
+    uint32_t total = 0, cap = 0;
+    ImplicacaoMapa *impl = NULL; uint32_t totalImpl = 0, capImpl = 0;
+    char linha[MAX_LINHA_MAPA];
+    unsigned long numLinha = 0;
+    int erro = 0;
+    while (!erro && fgets(linha, sizeof(linha), in)) {
+        numLinha++;
+        char *l = aparar(linha), *resto;
+        if (strncmp(l, "implica ", 8) == 0) {
+            // vão para o processo da mansão fixa na ordem do arquivo (a última de um par vale)
+            ImplicacaoMapa im;
+            if (lerImplica(l + 8, &im) != 0) { erro = 1; continue; }
+            if (totalImpl == capImpl) {
+                capImpl = capImpl ? capImpl * 2 : 64;
+                impl = (ImplicacaoMapa*) realloc(impl, capImpl * sizeof(ImplicacaoMapa));
+                if (!impl) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            impl[totalImpl++] = im;
+            continue;
+        }
+        if (strncmp(l, "associa ", 8) != 0) continue;
+        char *pista = separarBarra(l + 8, &resto);
+        if (!resto || !pista[0] || !resto[0]) { erro = 1; continue; }
+        IdTexto p = internar(pista), anterior = encontrarSuspeitoId(&indice, p);
+        if (anterior != SEM_TEXTO) {
+            suspeitos[anterior - 1] = internar(resto);
+            continue;
+        }
+        if (total == cap) {
+            cap = cap ? cap * 2 : 64;
+            pistas = (IdTexto*) realloc(pistas, cap * sizeof(IdTexto));
+            suspeitos = (IdTexto*) realloc(suspeitos, cap * sizeof(IdTexto));
+            if (!pistas || !suspeitos) { perror("realloc"); exit(EXIT_FAILURE); }
+        }
+        pistas[total] = p;
+        suspeitos[total++] = internar(resto);
+        inserirNaHashId(&indice, p, total);
+    }
+    fclose(in);
+    liberarHash(&indice);
+    if (erro || total == 0) {
+        fprintf(stderr, "%s:%lu: linha inválida ou nenhuma associação\n", entrada, numLinha);
+        free(pistas); free(suspeitos); free(impl);
+        return -1;
+    }
+
+    // chaves agrupadas (contagem por grupo + somas de prefixo)
+    uint32_t grupos = total / ASSOCIACOES_POR_GRUPO + 1;
+    uint32_t *inicio = (uint32_t*) calloc(grupos + 1, sizeof(uint32_t));
+    uint32_t *membros = (uint32_t*) malloc(total * sizeof(uint32_t));
+    uint32_t *deslocamentos = (uint32_t*) calloc(grupos, sizeof(uint32_t));
+    uint32_t *chaveDoSlot = (uint32_t*) malloc(total * sizeof(uint32_t));
+    uint64_t *ordem = (uint64_t*) malloc(grupos * sizeof(uint64_t));
+    if (!inicio || !membros || !deslocamentos || !chaveDoSlot || !ordem) {
+        perror("malloc"); exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < total; i++) inicio[grupoPerfeito(hashDoTexto(pistas[i]), grupos) + 1]++;
+    for (uint32_t g = 0; g < grupos; g++) {
+        ordem[g] = ((uint64_t) inicio[g + 1] << 32) | g;
+        inicio[g + 1] += inicio[g];
+    }
+    for (uint32_t g = 0; g < grupos; g++) chaveDoSlot[g] = inicio[g];   // cursor de cada grupo (grupos <= total)
+    for (uint32_t i = 0; i < total; i++)
+        membros[chaveDoSlot[grupoPerfeito(hashDoTexto(pistas[i]), grupos)]++] = i;
+    for (uint32_t i = 0; i < total; i++) chaveDoSlot[i] = UINT32_MAX;
+    qsort(ordem, grupos, sizeof(uint64_t), compararGrupos);
+
+    for (uint32_t k = 0; !erro && k < grupos && (ordem[k] >> 32) != 0; k++) {
+        uint32_t g = (uint32_t) ordem[k];
+        uint32_t de = inicio[g], ate = inicio[g + 1], d = 0, colocadas = 0;
+        for (; d < TENTATIVAS_DESLOCAMENTO; d++) {
+            for (colocadas = 0; de + colocadas < ate; colocadas++) {
+                uint32_t chave = membros[de + colocadas];
+                uint32_t slot = slotPerfeito(hashDoTexto(pistas[chave]), d, total);
+                if (chaveDoSlot[slot] != UINT32_MAX) break;
+                chaveDoSlot[slot] = chave;
+            }
+            if (de + colocadas == ate) break;
+            for (uint32_t j = 0; j < colocadas; j++)   // desfaz a tentativa
+                chaveDoSlot[slotPerfeito(hashDoTexto(pistas[membros[de + j]]), d, total)] = UINT32_MAX;
+        }
+        if (d == TENTATIVAS_DESLOCAMENTO) {
+            // só acontece se duas pistas diferentes tiverem o mesmo hash de 64 bits
+            fprintf(stderr, "%s: nenhum deslocamento separa o grupo %u\n", entrada, g);
+            erro = 1;
+        }
+        deslocamentos[g] = d;
+    }
+
+    FILE *out = erro ? NULL : fopen(saida, "w");
+    if (!erro && !out) { perror(saida); erro = 1; }
+    if (!erro) {
+        fprintf(out, "/* associacoes_fixas.h - gerado por: desafio_mestre --gerar-hash %s\n", entrada);
+        fprintf(out, "   Não editar. Hash perfeito mínimo das associações pista -> suspeito: o grupo\n"
+                     "   (bits altos do hashChave) dá o deslocamento e o deslocamento dá o slot.\n"
+                     "   As implicações do processo seguem na ordem do arquivo. */\n\n");
+        fprintf(out, "#ifndef ASSOCIACOES_FIXAS_H\n#define ASSOCIACOES_FIXAS_H\n\n");
+        fprintf(out, "#define TOTAL_ASSOCIACOES_FIXAS %u\n#define GRUPOS_ASSOCIACOES_FIXAS %u\n\n",
+                total, grupos);
+        fprintf(out, "static const uint32_t DESLOCAMENTOS_FIXOS[GRUPOS_ASSOCIACOES_FIXAS] = {");
+        for (uint32_t g = 0; g < grupos; g++)
+            fprintf(out, "%s%u", g % 12 ? ", " : (g ? ",\n    " : "\n    "), deslocamentos[g]);
+        fprintf(out, "\n};\n\nstatic const AssociacaoFixa ASSOCIACOES_FIXAS[TOTAL_ASSOCIACOES_FIXAS] = {\n");
+        for (uint32_t i = 0; i < total; i++) {
+            uint32_t chave = chaveDoSlot[i];
+            fprintf(out, "    { 0x%016llxULL, ", (unsigned long long) hashDoTexto(pistas[chave]));
+            escreverLiteralC(out, textoDe(pistas[chave]));
+            fputs(", ", out);
+            escreverLiteralC(out, textoDe(suspeitos[chave]));
+            fputs(" },\n", out);
+        }
+        fprintf(out, "};\n\n#define TOTAL_IMPLICACOES_FIXAS %u\n", totalImpl);
+        if (totalImpl) {
+            fprintf(out, "\nstatic const ImplicacaoFixa IMPLICACOES_FIXAS[TOTAL_IMPLICACOES_FIXAS] = {\n");
+            for (uint32_t i = 0; i < totalImpl; i++) {
+                fputs("    { ", out);
+                escreverLiteralC(out, textoDe(impl[i].pista));
+                fputs(", ", out);
+                escreverLiteralC(out, textoDe(impl[i].suspeito));
+                fprintf(out, ", %u },\n", impl[i].peso);
+            }
+            fprintf(out, "};\n");
+        }
+        fprintf(out, "\n#endif\n");
+        if (ferror(out) | fclose(out)) { perror(saida); erro = 1; }
+    }
+    free(pistas); free(suspeitos); free(impl);
+    free(inicio); free(membros); free(deslocamentos); free(chaveDoSlot); free(ordem);
+    return erro ? -1 : 0;
+}
+
+/* carregarMapa: valida o cabeçalho e aponta os vetores da MansaoPlana para dentro do arquivo.
+   Só os textos de pistas/suspeitos são internados; nomes de salas são lidos direto do pool. */
+int carregarMapa(const char *caminho, MapaBinario *mapa, TabelaHash *hash, Processo *processo) {
+    memset(mapa, 0, sizeof(*mapa));
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) { perror(caminho); return -1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { perror(caminho); close(fd); return -1; }
+    size_t tam = (size_t) st.st_size;
+    if (tam < sizeof(CabecalhoMapa)) {
+        fprintf(stderr, "%s: arquivo de mapa truncado\n", caminho);
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) { perror("mmap"); return -1; }
+
+    const CabecalhoMapa *cab = (const CabecalhoMapa*) base;
+    // a versão 1 difere só na ordem das associações, que aqui não importa; antes da 3 não
+    // há implicações
+    int valido = memcmp(cab->magia, MAPA_MAGIA, 4) == 0 && cab->versao >= 1 && cab->versao <= MAPA_VERSAO &&
+        cab->totalTextosChave <= cab->totalTextos && cab->totalTextos > 0 &&
+        cab->offSalas + (uint64_t) cab->totalSalas * sizeof(SalaPlana) <= tam &&
+        cab->offNomes + (uint64_t) cab->totalSalas * sizeof(uint32_t) <= tam &&
+        cab->offTextos + (uint64_t) cab->totalTextos * sizeof(uint64_t) <= tam &&
+        cab->offPool + cab->tamPool <= tam && cab->tamPool > 0 &&
+        offImplicacoes(cab) + (uint64_t) implicacoesDoMapa(cab) * sizeof(ImplicacaoMapa) <= tam &&
+        (cab->offSalas | cab->offNomes | cab->offTextos | cab->offAssociacoes) % 8 == 0 &&
+        ((const char*) base)[cab->offPool + cab->tamPool - 1] == '\0';
+    if (!valido) {
+        fprintf(stderr, "%s: arquivo de mapa inválido\n", caminho);
+        munmap(base, tam);
+        return -1;
+    }
+    if (validarArvoreSalas((const SalaPlana*) ((const char*) base + cab->offSalas), cab->totalSalas,
+                           cab->raiz) != 0) {
+        fprintf(stderr, "%s: as salas do mapa não formam uma árvore\n", caminho);
+        munmap(base, tam);
+        return -1;
+    }
+
+    const uint64_t *offTextos = (const uint64_t*) ((const char*) base + cab->offTextos);
+    const char *pool = (const char*) base + cab->offPool;
+    ESTAT_ALOCACAO(ALOC_MAPA, 1);
+    mapa->ids = (IdTexto*) malloc(cab->totalTextosChave * sizeof(IdTexto));
+    if (!mapa->ids) { perror("malloc"); exit(EXIT_FAILURE); }
+    for (uint32_t i = 0; i < cab->totalTextosChave; i++)
+        mapa->ids[i] = offTextos[i] < cab->tamPool ? internar(pool + offTextos[i]) : SEM_TEXTO;
+
+    const AssociacaoMapa *assoc = (const AssociacaoMapa*) ((const char*) base + cab->offAssociacoes);
+    reservarHash(hash, hash->tamanho + cab->totalAssociacoes);
+    for (uint32_t i = 0; i < cab->totalAssociacoes; i++) {
+        if (assoc[i].pista < cab->totalTextosChave && assoc[i].suspeito < cab->totalTextosChave)
+            inserirNaHashId(hash, mapa->ids[assoc[i].pista], mapa->ids[assoc[i].suspeito]);
+    }
+    if (processo) {
+        // associações com PESO_ASSOCIACAO; as implicações vêm depois e prevalecem
+        const ImplicacaoMapa *impl = (const ImplicacaoMapa*) ((const char*) base + offImplicacoes(cab));
+        for (uint32_t i = 0; i < cab->totalAssociacoes; i++)
+            if (assoc[i].pista < cab->totalTextosChave && assoc[i].suspeito < cab->totalTextosChave)
+                registrarImplicacao(processo, mapa->ids[assoc[i].pista], mapa->ids[assoc[i].suspeito],
+                                    PESO_ASSOCIACAO);
+        for (uint32_t i = 0; i < implicacoesDoMapa(cab); i++)
+            if (impl[i].pista < cab->totalTextosChave && impl[i].suspeito < cab->totalTextosChave)
+                registrarImplicacao(processo, mapa->ids[impl[i].pista], mapa->ids[impl[i].suspeito], impl[i].peso);
+    }
+
+    mapa->base = base;
+    mapa->tamanho = tam;
+    MansaoPlana *mp = &mapa->mansao;
+    mp->salas = (const SalaPlana*) ((const char*) base + cab->offSalas);
+    mp->nomes = (const uint32_t*) ((const char*) base + cab->offNomes);
+    mp->total = cab->totalSalas;
+    mp->raiz = cab->raiz;
+    mp->offTextos = offTextos;
+    mp->pool = pool;
+    mp->tamPool = cab->tamPool;
+    mp->totalTextos = cab->totalTextos;
+    mp->ids = mapa->ids;
+    mp->totalIds = cab->totalTextosChave;
+    return 0;
+}
+
+void fecharMapa(MapaBinario *mapa) {
+    if (mapa->base) munmap(mapa->base, mapa->tamanho);
+    free(mapa->ids);
+    memset(mapa, 0, sizeof(*mapa));
+}
@@ -0,0 +1,78 @@
+/* mapa.h – mapa binário (.dqm) */
+#ifndef MESTRE_MAPA_H
+#define MESTRE_MAPA_H
+
+#include "mansao.h"
+#include "processo.h"
+
+#define MAPA_MAGIA "DQM1"
+#define MAPA_VERSAO 3                 // 2: associações ordenadas por pista (busca binária); 3: implicações
+#define MAX_LINHA_MAPA 1024
+#define ASSOCIACOES_POR_GRUPO 4      // média de chaves por grupo no hash perfeito gerado
+#define TENTATIVAS_DESLOCAMENTO (1u << 24)   // desiste do grupo após tantos deslocamentos
+
+/* Cabeçalho do arquivo binário de mapa. Seções seguintes (offsets a partir do
+   início do arquivo, alinhados a 8): SalaPlana[totalSalas], uint32 nomes[totalSalas],
+   uint64 offTextos[totalTextos], pool de textos terminados em '\0' (na ordem dos índices)
+   e AssociacaoMapa[totalAssociacoes], sem pistas repetidas e ordenadas por pista desde a
+   versão 2. A versão 3 acrescenta ImplicacaoMapa[totalImplicacoes] logo após as
+   associações, na ordem do texto. O texto 0 é sempre "" (nenhum). */
+typedef struct CabecalhoMapa {
+    char magia[4];
+    uint32_t versao;
+    uint32_t totalSalas;
+    uint32_t raiz;
+    uint32_t totalTextos;
+    uint32_t totalTextosChave;  // textos [0, totalTextosChave) são pistas/suspeitos
+    uint32_t totalAssociacoes;
+    uint32_t totalImplicacoes;  // versão 3 (antes reservado, sempre 0)
+    uint64_t offSalas, offNomes, offTextos, offPool, tamPool, offAssociacoes;
+} CabecalhoMapa;
+
+/* Associação pista -> suspeito no arquivo (índices de texto) */
+typedef struct AssociacaoMapa {
+    uint32_t pista;
+    uint32_t suspeito;
+} AssociacaoMapa;
+
+/* Implicação pista -> suspeito com peso no arquivo (índices de texto chave) */
+typedef struct ImplicacaoMapa {
+    uint32_t pista;
+    uint32_t suspeito;
+    uint32_t peso;
+} ImplicacaoMapa;
+
+/* Mapa binário aberto: memória mapeada e tradução de textos para IdTexto */
+typedef struct MapaBinario {
+    void *base;
+    size_t tamanho;
+    IdTexto *ids;
+    MansaoPlana mansao;
+} MapaBinario;
+
+/* converterMapaTexto() – gera o mapa binário a partir da descrição em texto:
+     sala <nome> [| <pista>]         salas numeradas na ordem (0 é a entrada)
+     liga <pai> <esquerda> <direita> índices de sala ('-' = sem caminho)
+     associa <pista> | <suspeito>
+     implica <pista> | <suspeito> | <peso>   peso 0..PESO_MAXIMO no processo do caso
+   Linhas vazias e iniciadas por '#' são ignoradas. Retorna 0 ou -1 em erro. */
+int converterMapaTexto(const char *entrada, const char *saida);
+
+/* carregarMapa() – mapeia o arquivo binário (mmap) e o usa no lugar, sem alocar por sala.
+   As associações vão para 'hash' e, com 'processo' != NULL, também as implicações (a
+   compilação fica com o chamador). Retorna 0 ou -1 em erro. */
+int carregarMapa(const char *caminho, MapaBinario *mapa, TabelaHash *hash, Processo *processo);
+
+void fecharMapa(MapaBinario *mapa);
+
+/* gerarHashPerfeito() – lê as linhas "associa <pista> | <suspeito>" (o formato de
+   converterMapaTexto; as demais linhas são ignoradas) e grava um cabeçalho C com o hash
+   perfeito mínimo delas. Retorna 0 ou -1 em erro. */
+int gerarHashPerfeito(const char *entrada, const char *saida);
+
+/* implicacoesDoMapa() / offImplicacoes() – total e offset da seção de implicações (versão 3;
+   antes dela o total era reservado e gravado como 0). */
+uint32_t implicacoesDoMapa(const CabecalhoMapa *cab);
+uint64_t offImplicacoes(const CabecalhoMapa *cab);
+
+#endif
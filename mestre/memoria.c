@@ -0,0 +1,70 @@
+/* memoria.c – arena de memória por sessão (bump allocator) e alocação de nós */
+
+#include "memoria.h"
+
+/* arena da thread atual (cada sessão/thread usa a sua) */
+_Thread_local Arena *arenaAtual = NULL;
+
+void usarArena(Arena *arena) {
+    arenaAtual = arena;
+}
+
+static BlocoArena* novoBlocoArena(size_t capacidade) {
+    ESTAT_ALOCACAO(ALOC_ARENA, 1);
+    BlocoArena *b = (BlocoArena*) malloc(sizeof(BlocoArena) + capacidade);
+    if (!b) { perror("malloc"); exit(EXIT_FAILURE); }
+    b->proximo = NULL;
+    b->usado = 0;
+    b->capacidade = capacidade;
+    return b;
+}
+
+/* arenaAlocar: avança no bloco atual; ao esgotar, reaproveita o próximo ou cria um novo */
+void* arenaAlocar(Arena *arena, size_t tam) {
+    const size_t alinhamento = _Alignof(max_align_t);
+    tam = (tam + alinhamento - 1) & ~(alinhamento - 1);
+    BlocoArena *b = arena->atual;
+    while (b && b->usado + tam > b->capacidade) {
+        b = b->proximo;
+        if (b) b->usado = 0;
+    }
+    if (!b) {
+        b = novoBlocoArena(tam > ARENA_BLOCO ? tam : ARENA_BLOCO);
+        if (arena->atual) {
+            // encaixa o novo bloco logo após o atual
+            b->proximo = arena->atual->proximo;
+            arena->atual->proximo = b;
+        } else {
+            b->proximo = arena->primeiro;
+            arena->primeiro = b;
+        }
+    }
+    arena->atual = b;
+    void *p = (unsigned char*) b->dados + b->usado;
+    b->usado += tam;
+    return p;
+}
+
+void arenaResetar(Arena *arena) {
+    arena->atual = arena->primeiro;
+    if (arena->atual) arena->atual->usado = 0;
+}
+
+void arenaLiberar(Arena *arena) {
+    BlocoArena *b = arena->primeiro;
+    while (b) {
+        BlocoArena *t = b->proximo;
+        free(b);
+        b = t;
+    }
+    arena->primeiro = arena->atual = NULL;
+}
+
+/* alocarNo: usa a arena da thread, se houver; senão malloc individual */
+void* alocarNo(size_t tam, EstruturaAlocada estrutura) {
+    if (arenaAtual) return arenaAlocar(arenaAtual, tam);
+    ESTAT_ALOCACAO(estrutura, 1);
+    void *p = malloc(tam);
+    if (!p) { perror("malloc"); exit(EXIT_FAILURE); }
+    return p;
+}
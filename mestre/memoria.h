@@ -0,0 +1,44 @@
+/* memoria.h – arena de memória por sessão */
+#ifndef MESTRE_MEMORIA_H
+#define MESTRE_MEMORIA_H
+
+#include "comum.h"
+
+#define ARENA_BLOCO (64 * 1024)      // tamanho padrão de cada bloco da arena
+
+/* Bloco de memória da arena (os dados vêm logo após o cabeçalho) */
+typedef struct BlocoArena {
+    struct BlocoArena *proximo;
+    size_t usado;
+    size_t capacidade;
+    max_align_t dados[];
+} BlocoArena;
+
+/* Arena (bump allocator): dona de todos os nós de uma sessão.
+   Os blocos são mantidos após arenaResetar() para reaproveitamento. */
+typedef struct Arena {
+    BlocoArena *primeiro;
+    BlocoArena *atual;
+} Arena;
+
+/* arena da thread atual (cada sessão/thread usa a sua; NULL = malloc individual) */
+extern _Thread_local Arena *arenaAtual;
+
+/* usarArena() – define a arena da thread atual para criarSala/inserirPista/inserirNaHash.
+   NULL volta ao malloc individual. Objetos vindos de arena não vão para liberar*(). */
+void usarArena(Arena *arena);
+
+/* arenaAlocar() – reserva 'tam' bytes alinhados na arena. */
+void* arenaAlocar(Arena *arena, size_t tam);
+
+/* arenaResetar() – descarta todos os objetos da sessão em O(1) por bloco, mantendo os blocos. */
+void arenaResetar(Arena *arena);
+
+/* arenaLiberar() – devolve os blocos da arena ao sistema. */
+void arenaLiberar(Arena *arena);
+
+/* alocarNo() – um nó de 'tam' bytes: da arena da thread, se houver, ou do malloc
+   (contado em 'estrutura' nas estatísticas). Nunca devolve NULL. */
+void* alocarNo(size_t tam, EstruturaAlocada estrutura);
+
+#endif
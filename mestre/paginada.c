@@ -0,0 +1,253 @@
+/* paginada.c – mansão paginada: salas do .dqm lidas sob demanda (pread) num cache LRU */
+
+#include "paginada.h"
+#include "associacoes.h"
+#include "hash.h"
+#include "textos.h"
+
+/* lerNoArquivo: pread completo (repete nas leituras parciais) */
+static int lerNoArquivo(int fd, void *destino, size_t tam, uint64_t offset) {
+    unsigned char *p = (unsigned char*) destino;
+    while (tam) {
+        ssize_t r = pread(fd, p, tam, (off_t) offset);
+        if (r <= 0) return -1;
+        p += r;
+        tam -= (size_t) r;
+        offset += (uint64_t) r;
+    }
+    return 0;
+}
+
+/* falhaPaginada: erro de leitura vira sala/texto vazio; avisa só na primeira vez */
+static void falhaPaginada(MansaoPaginada *pg) {
+    if (pg->falhas++ == 0) fprintf(stderr, "mansão paginada: falha de leitura no mapa\n");
+}
+
+/* lerTextoPaginado: texto 't' do pool em (*buf, *cap). O tamanho sai do offset seguinte
+   (os textos são gravados em sequência), então bastam duas leituras. */
+static const char* lerTextoPaginado(MansaoPaginada *pg, uint32_t t, char **buf, size_t *cap) {
+    const CabecalhoMapa *cab = &pg->cab;
+    uint64_t off[2] = { 0, cab->tamPool };
+    if (t >= cab->totalTextos) return "";
+    size_t n = t + 1 < cab->totalTextos ? 2 : 1;
+    if (lerNoArquivo(pg->fd, off, n * sizeof(uint64_t), cab->offTextos + (uint64_t) t * sizeof(uint64_t)) ||
+        off[0] >= off[1] || off[1] > cab->tamPool) {
+        falhaPaginada(pg);
+        return "";
+    }
+    size_t L = (size_t) (off[1] - off[0]);   // inclui o '\0'
+    if (L > *cap) {
+        ESTAT_ALOCACAO(ALOC_MAPA, 1);
+        char *novo = (char*) realloc(*buf, L);
+        if (!novo) { perror("realloc"); exit(EXIT_FAILURE); }
+        *buf = novo;
+        *cap = L;
+    }
+    if (lerNoArquivo(pg->fd, *buf, L, cab->offPool + off[0])) {
+        falhaPaginada(pg);
+        return "";
+    }
+    (*buf)[L - 1] = '\0';
+    return *buf;
+}
+
+/* idTextoPaginado: índice de texto de pista/suspeito -> IdTexto, lendo só na primeira vez */
+static IdTexto idTextoPaginado(MansaoPaginada *pg, uint32_t t) {
+    if (t == 0 || t >= pg->cab.totalTextosChave) return SEM_TEXTO;
+    IdTexto id = encontrarSuspeitoId(&pg->textos, t);
+    if (id != SEM_TEXTO) return id;
+    id = internar(lerTextoPaginado(pg, t, &pg->texto, &pg->capTexto));
+    inserirNaHashId(&pg->textos, t, id);
+    return id;
+}
+
+/* pistaPaginada: como idTextoPaginado, e na primeira vez busca a associação da pista
+   (busca binária no vetor ordenado do arquivo) e a registra na tabela do jogo */
+static IdTexto pistaPaginada(MansaoPaginada *pg, uint32_t t) {
+    IdTexto id = encontrarSuspeitoId(&pg->pistas, t);
+    if (id != SEM_TEXTO || (id = idTextoPaginado(pg, t)) == SEM_TEXTO) return id;
+    uint32_t de = 0, ate = pg->cab.totalAssociacoes;
+    while (de < ate) {
+        uint32_t meio = de + (ate - de) / 2;
+        AssociacaoMapa a;
+        if (lerNoArquivo(pg->fd, &a, sizeof(a), pg->cab.offAssociacoes + (uint64_t) meio * sizeof(a))) {
+            falhaPaginada(pg);
+            break;
+        }
+        if (a.pista < t) de = meio + 1;
+        else if (a.pista > t) ate = meio;
+        else {
+            inserirNaHashId(pg->associacoes, id, idTextoPaginado(pg, a.suspeito));
+            break;
+        }
+    }
+    inserirNaHashId(&pg->pistas, t, id);
+    return id;
+}
+
+/* esquecerPistaPaginada: a sala que sai do cache leva a tradução da sua pista. Se outra
+   sala residente tiver o mesmo texto, ela já tem o IdTexto; só a próxima carga relê. */
+static void esquecerPistaPaginada(MansaoPaginada *pg, uint32_t t) {
+    TabelaHash *tabelas[2] = { &pg->pistas, &pg->textos };
+    for (int k = 0; k < 2; k++) {
+        long i = buscarSlot(tabelas[k], hashId(t), t, NULL);
+        if (i >= 0) removerSlot(tabelas[k], (size_t) i);
+    }
+}
+
+/* desligarSala / ligarNaFrente: manutenção da lista LRU (frente = mais recente) */
+static void desligarSala(MansaoPaginada *pg, uint32_t slot) {
+    SalaPaginada *s = &pg->cache[slot];
+    if (s->anterior != SALA_NENHUMA) pg->cache[s->anterior].proxima = s->proxima;
+    else pg->maisRecente = s->proxima;
+    if (s->proxima != SALA_NENHUMA) pg->cache[s->proxima].anterior = s->anterior;
+    else pg->menosRecente = s->anterior;
+}
+
+static void ligarNaFrente(MansaoPaginada *pg, uint32_t slot) {
+    SalaPaginada *s = &pg->cache[slot];
+    s->anterior = SALA_NENHUMA;
+    s->proxima = pg->maisRecente;
+    if (pg->maisRecente != SALA_NENHUMA) pg->cache[pg->maisRecente].anterior = slot;
+    pg->maisRecente = slot;
+    if (pg->menosRecente == SALA_NENHUMA) pg->menosRecente = slot;
+}
+
+/* carregarSalaPaginada: registro de navegação, nome e pista da sala 'indice' */
+static void carregarSalaPaginada(MansaoPaginada *pg, SalaPaginada *s, uint32_t indice) {
+    const CabecalhoMapa *cab = &pg->cab;
+    uint32_t nome = 0;
+    s->indice = indice;
+    if (lerNoArquivo(pg->fd, &s->registro, sizeof(SalaPlana), cab->offSalas + (uint64_t) indice * sizeof(SalaPlana)) ||
+        lerNoArquivo(pg->fd, &nome, sizeof(nome), cab->offNomes + (uint64_t) indice * sizeof(uint32_t))) {
+        falhaPaginada(pg);
+        s->registro.esquerda = s->registro.direita = SALA_NENHUMA;
+        s->registro.pista = 0;
+    }
+    const char *lido = lerTextoPaginado(pg, nome, &s->nome, &s->capNome);
+    if (lido != s->nome) {   // texto vazio ou falha: o buffer do slot pode ainda não existir
+        if (!s->capNome) {
+            ESTAT_ALOCACAO(ALOC_MAPA, 1);
+            s->nome = (char*) malloc(MAX_NOME);
+            if (!s->nome) { perror("malloc"); exit(EXIT_FAILURE); }
+            s->capNome = MAX_NOME;
+        }
+        s->nome[0] = '\0';
+    }
+    s->pista = pistaPaginada(pg, s->registro.pista);
+}
+
+/* salaResidente: acerto move a sala para a frente da LRU; falta ocupa um slot livre ou
+   o da sala menos recente, que sai do índice de residentes levando a sua pista */
+SalaPaginada* salaResidente(MansaoPaginada *pg, uint32_t indice) {
+    long i = buscarSlot(&pg->residentes, hashId(indice + 1), indice + 1, NULL);
+    uint32_t slot;
+    if (i >= 0) {
+        slot = pg->residentes.entradas[i].suspeito - 1;
+        pg->acertos++;
+        if (slot != pg->maisRecente) {
+            desligarSala(pg, slot);
+            ligarNaFrente(pg, slot);
+        }
+        return &pg->cache[slot];
+    }
+    pg->leituras++;
+    if (pg->ocupadas < pg->capacidade) {
+        slot = pg->ocupadas++;
+    } else {
+        slot = pg->menosRecente;
+        desligarSala(pg, slot);
+        uint32_t chave = pg->cache[slot].indice + 1;
+        removerSlot(&pg->residentes, (size_t) buscarSlot(&pg->residentes, hashId(chave), chave, NULL));
+        esquecerPistaPaginada(pg, pg->cache[slot].registro.pista);
+    }
+    carregarSalaPaginada(pg, &pg->cache[slot], indice);
+    inserirNaHashId(&pg->residentes, indice + 1, slot + 1);
+    ligarNaFrente(pg, slot);
+    return &pg->cache[slot];
+}
+
+/* lerProcessoPaginado: associações (com PESO_ASSOCIACAO) e depois implicações, que
+   prevalecem, lidas de uma vez; os textos são traduzidos como os das salas */
+static int lerProcessoPaginado(MansaoPaginada *pg, Processo *processo) {
+    const CabecalhoMapa *cab = &pg->cab;
+    uint32_t total = implicacoesDoMapa(cab);
+    size_t tam = (size_t) cab->totalAssociacoes * sizeof(AssociacaoMapa) + (size_t) total * sizeof(ImplicacaoMapa);
+    ESTAT_ALOCACAO(ALOC_MAPA, 1);
+    unsigned char *buf = (unsigned char*) malloc(tam ? tam : 1);
+    if (!buf) { perror("malloc"); exit(EXIT_FAILURE); }
+    if (lerNoArquivo(pg->fd, buf, tam, cab->offAssociacoes) != 0) { free(buf); return -1; }
+    const AssociacaoMapa *assoc = (const AssociacaoMapa*) buf;
+    const ImplicacaoMapa *impl = (const ImplicacaoMapa*) (assoc + cab->totalAssociacoes);
+    for (uint32_t i = 0; i < cab->totalAssociacoes; i++)
+        registrarImplicacao(processo, idTextoPaginado(pg, assoc[i].pista),
+                            idTextoPaginado(pg, assoc[i].suspeito), PESO_ASSOCIACAO);
+    for (uint32_t i = 0; i < total; i++)
+        registrarImplicacao(processo, idTextoPaginado(pg, impl[i].pista),
+                            idTextoPaginado(pg, impl[i].suspeito), impl[i].peso);
+    free(buf);
+    return 0;
+}
+
+/* abrirMansaoPaginada: valida o cabeçalho contra o tamanho do arquivo; nenhuma sala é lida */
+int abrirMansaoPaginada(const char *caminho, uint32_t capacidade, TabelaHash *hash, Processo *processo,
+                        MansaoPaginada *pg) {
+    memset(pg, 0, sizeof(*pg));
+    pg->fd = open(caminho, O_RDONLY);
+    if (pg->fd < 0) { perror(caminho); return -1; }
+    struct stat st;
+    const CabecalhoMapa *cab = &pg->cab;
+    if (fstat(pg->fd, &st) != 0 || lerNoArquivo(pg->fd, &pg->cab, sizeof(pg->cab), 0) != 0) {
+        fprintf(stderr, "%s: arquivo de mapa truncado\n", caminho);
+        close(pg->fd);
+        return -1;
+    }
+    uint64_t tam = (uint64_t) st.st_size;
+    int valido = memcmp(cab->magia, MAPA_MAGIA, 4) == 0 && cab->versao >= 2 && cab->versao <= MAPA_VERSAO &&
+        cab->totalTextosChave <= cab->totalTextos && cab->totalTextos > 0 &&
+        cab->offSalas + (uint64_t) cab->totalSalas * sizeof(SalaPlana) <= tam &&
+        cab->offNomes + (uint64_t) cab->totalSalas * sizeof(uint32_t) <= tam &&
+        cab->offTextos + (uint64_t) cab->totalTextos * sizeof(uint64_t) <= tam &&
+        cab->offPool + cab->tamPool <= tam && cab->tamPool > 0 &&
+        offImplicacoes(cab) + (uint64_t) implicacoesDoMapa(cab) * sizeof(ImplicacaoMapa) <= tam;
+    if (!valido) {
+        if (memcmp(cab->magia, MAPA_MAGIA, 4) == 0 && cab->versao < 2)
+            fprintf(stderr, "%s: mapa da versão %u; gere de novo com --converter para paginar\n",
+                    caminho, cab->versao);
+        else
+            fprintf(stderr, "%s: arquivo de mapa inválido\n", caminho);
+        close(pg->fd);
+        return -1;
+    }
+
+    pg->capacidade = capacidade < CACHE_SALAS_MINIMO ? CACHE_SALAS_MINIMO : capacidade;
+    ESTAT_ALOCACAO(ALOC_MAPA, 1);
+    pg->cache = (SalaPaginada*) calloc(pg->capacidade, sizeof(SalaPaginada));
+    if (!pg->cache) { perror("calloc"); exit(EXIT_FAILURE); }
+    pg->maisRecente = pg->menosRecente = SALA_NENHUMA;
+    TabelaHash *tabelas[3] = { &pg->residentes, &pg->textos, &pg->pistas };
+    for (int i = 0; i < 3; i++) {
+        inicializarHash(tabelas[i]);
+        tabelas[i]->arena = NULL;   // vivem tanto quanto o mapa, fora das arenas
+    }
+    reservarHash(&pg->residentes, pg->capacidade);   // nunca cresce: no máximo 'capacidade' salas
+    pg->associacoes = hash;
+    if (processo && lerProcessoPaginado(pg, processo) != 0) {
+        fprintf(stderr, "%s: arquivo de mapa truncado\n", caminho);
+        fecharMansaoPaginada(pg);
+        return -1;
+    }
+    return 0;
+}
+
+void fecharMansaoPaginada(MansaoPaginada *pg) {
+    if (!pg->cache) return;
+    for (uint32_t i = 0; i < pg->capacidade; i++) free(pg->cache[i].nome);
+    free(pg->cache);
+    free(pg->texto);
+    liberarHash(&pg->residentes);
+    liberarHash(&pg->textos);
+    liberarHash(&pg->pistas);
+    close(pg->fd);
+    memset(pg, 0, sizeof(*pg));
+}
@@ -0,0 +1,58 @@
+/* paginada.h – mansão lida do .dqm sob demanda */
+#ifndef MESTRE_PAGINADA_H
+#define MESTRE_PAGINADA_H
+
+#include "mapa.h"
+
+#define MAX_NOME 64
+#define CACHE_SALAS_PADRAO 4096      // salas residentes na mansão paginada
+#define CACHE_SALAS_MINIMO 4         // a sala atual e os dois filhos exibidos cabem sempre
+
+/* Sala residente no cache da mansão paginada */
+typedef struct SalaPaginada {
+    uint32_t indice;            // número da sala no arquivo
+    SalaPlana registro;         // filhos e índice de texto da pista, como no arquivo
+    IdTexto pista;              // já traduzida (SEM_TEXTO se não houver)
+    char *nome;                 // buffer do slot, reaproveitado entre as salas
+    size_t capNome;
+    uint32_t anterior, proxima; // lista LRU (posições no cache; SALA_NENHUMA nas pontas)
+} SalaPaginada;
+
+/* Mansão lida do .dqm sob demanda: na abertura só o cabeçalho é lido; cada sala vem com
+   pread na primeira visita e fica num cache LRU de capacidade fixa. Pistas e suspeitos
+   são traduzidos para IdTexto (e as associações registradas) conforme aparecem.
+   Memória: a tradução da pista sai do cache junto com a sua sala, e a dos suspeitos fica
+   (no máximo um por texto de suspeito do mapa). O que fica por pista visitada é o texto
+   internado e a associação no jogo, que as árvores de pistas das sessões referenciam:
+   cresce com as pistas distintas coletadas, não com as salas, e uma pista que volta é
+   internada de novo no mesmo IdTexto. */
+typedef struct MansaoPaginada {
+    int fd;
+    CabecalhoMapa cab;
+    SalaPaginada *cache;
+    uint32_t capacidade, ocupadas;
+    uint32_t maisRecente, menosRecente;
+    TabelaHash residentes;      // sala + 1 -> posição no cache + 1
+    TabelaHash textos;          // índice de texto -> IdTexto (suspeitos e pistas residentes)
+    TabelaHash pistas;          // índice de texto -> IdTexto, com a associação já buscada
+                                // (só as pistas de salas residentes)
+    TabelaHash *associacoes;    // tabela pista -> suspeito do jogo, preenchida aos poucos
+    char *texto;                // buffer de leitura de pistas/suspeitos
+    size_t capTexto;
+    unsigned long leituras, acertos, falhas;
+} MansaoPaginada;
+
+/* abrirMansaoPaginada() – abre o mapa (versão 2 ou 3) para leitura sob demanda com até
+   'capacidade' salas residentes; só o cabeçalho é lido aqui. As associações das pistas
+   encontradas entram em 'hash' durante o jogo. Com 'processo' != NULL, associações e
+   implicações são lidas inteiras na abertura. O cache não é compartilhável entre threads.
+   Retorna 0 ou -1 em erro. Fechar com fecharMansaoPaginada(). */
+int abrirMansaoPaginada(const char *caminho, uint32_t capacidade, TabelaHash *hash, Processo *processo,
+                        MansaoPaginada *pg);
+void fecharMansaoPaginada(MansaoPaginada *pg);
+
+/* salaResidente() – a sala 'indice', do cache ou lida do arquivo agora (a menos recente
+   sai). O ponteiro vale até a próxima chamada que carregar outra sala. */
+SalaPaginada* salaResidente(MansaoPaginada *pg, uint32_t indice);
+
+#endif
@@ -0,0 +1,546 @@
+/* pistas.c – árvore de pistas: AVL com estatísticas de ordem, versão persistente e carga
+   em lote */
+
+#include "pistas.h"
+#include "memoria.h"
+#include "textos.h"
+
+/* utilitários AVL: altura, tamanho, rotações e rebalanceamento de um nó */
+int alturaPista(const PistaNode *n) {
+    return n ? n->altura : 0;
+}
+
+uint32_t tamanhoPista(const PistaNode *n) {
+    return n ? n->tamanho : 0;
+}
+
+static uint64_t ocorrenciasPista(const PistaNode *n) {
+    return n ? n->ocorrenciasSubarvore : 0;
+}
+
+/* atualizarNo: altura, tamanho e soma de ocorrências a partir dos filhos */
+static void atualizarNo(PistaNode *n) {
+    int he = alturaPista(n->esquerda), hd = alturaPista(n->direita);
+    n->altura = (he > hd ? he : hd) + 1;
+    n->tamanho = tamanhoPista(n->esquerda) + tamanhoPista(n->direita) + 1;
+    n->ocorrenciasSubarvore = ocorrenciasPista(n->esquerda) + ocorrenciasPista(n->direita) +
+                              (uint64_t) n->ocorrencias;
+}
+
+static PistaNode* rotacionarDireita(PistaNode *y) {
+    PistaNode *x = y->esquerda;
+    y->esquerda = x->direita;
+    x->direita = y;
+    atualizarNo(y);
+    atualizarNo(x);
+    return x;
+}
+
+static PistaNode* rotacionarEsquerda(PistaNode *x) {
+    PistaNode *y = x->direita;
+    x->direita = y->esquerda;
+    y->esquerda = x;
+    atualizarNo(x);
+    atualizarNo(y);
+    return y;
+}
+
+static PistaNode* balancearPista(PistaNode *n) {
+    atualizarNo(n);
+    int fator = alturaPista(n->esquerda) - alturaPista(n->direita);
+    if (fator > 1) {
+        if (alturaPista(n->esquerda->esquerda) < alturaPista(n->esquerda->direita))
+            n->esquerda = rotacionarEsquerda(n->esquerda);   // caso esquerda-direita
+        return rotacionarDireita(n);
+    }
+    if (fator < -1) {
+        if (alturaPista(n->direita->direita) < alturaPista(n->direita->esquerda))
+            n->direita = rotacionarDireita(n->direita);      // caso direita-esquerda
+        return rotacionarEsquerda(n);
+    }
+    return n;
+}
+
+/* prefixoTexto: até 8 bytes do texto em big-endian, completados com zero; a ordem dos
+   inteiros é a do strcmp nesses bytes (o '\0' final ordena como o zero do complemento) */
+uint64_t prefixoTexto(const char *texto) {
+    unsigned char bytes[8] = { 0 };
+    memcpy(bytes, texto, strnlen(texto, sizeof(bytes)));
+    uint64_t p = 0;
+    for (int i = 0; i < 8; i++) p = (p << 8) | bytes[i];
+    return p;
+}
+
+/* inserirPistaPrefixo: o strcmp só roda quando os prefixos empatam (textos distintos
+   com prefixos iguais têm ambos pelo menos 8 bytes) */
+static PistaNode* inserirPistaPrefixo(PistaNode *raiz, IdTexto pista, uint64_t prefixo, int vezes) {
+    if (raiz == NULL) {
+        PistaNode *n = (PistaNode*) alocarNo(sizeof(PistaNode), ALOC_PISTAS);
+        n->prefixo = prefixo;
+        n->pista = pista;
+        n->ocorrencias = vezes;
+        n->altura = 1;
+        n->tamanho = 1;
+        n->referencias = 1;
+        n->ocorrenciasSubarvore = (uint64_t) vezes;
+        n->esquerda = n->direita = NULL;
+        return n;
+    }
+    if (pista == raiz->pista) {
+        raiz->ocorrencias += vezes;
+        raiz->ocorrenciasSubarvore += (uint64_t) vezes;
+        return raiz;   // estrutura inalterada; os ancestrais refazem a soma em balancearPista
+    } else if (prefixo != raiz->prefixo ? prefixo < raiz->prefixo
+                                        : strcmp(textoDe(pista) + 8, textoDe(raiz->pista) + 8) < 0) {
+        raiz->esquerda = inserirPistaPrefixo(raiz->esquerda, pista, prefixo, vezes);
+    } else {
+        raiz->direita = inserirPistaPrefixo(raiz->direita, pista, prefixo, vezes);
+    }
+    return balancearPista(raiz);
+}
+
+/* inserirPista: insere pista na árvore AVL. Se já existe, incrementa ocorrencias.
+   Igualdade sai da comparação de ids; o lado sai do prefixo calculado uma vez. */
+PistaNode* inserirPista(PistaNode *raiz, IdTexto pista) {
+    if (pista == SEM_TEXTO) return raiz;
+    return inserirPistaPrefixo(raiz, pista, prefixoTexto(textoDe(pista)), 1);
+}
+
+/* ------------------ Árvore persistente ------------------ */
+
+/* novaPistaContada: nós persistentes saem do malloc para poderem ser liberados um a um */
+static PistaNode* novaPistaContada(void) {
+    ESTAT_ALOCACAO(ALOC_PISTAS, 1);
+    PistaNode *n = (PistaNode*) malloc(sizeof(PistaNode));
+    if (!n) { perror("malloc"); exit(EXIT_FAILURE); }
+    return n;
+}
+
+PistaNode* reterPistas(PistaNode *raiz) {
+    if (raiz) raiz->referencias++;
+    return raiz;
+}
+
+/* soltarPistas: a recursão só desce à esquerda (a direita vira laço), então a pilha
+   não passa da altura mesmo liberando a árvore inteira */
+void soltarPistas(PistaNode *raiz) {
+    while (raiz && --raiz->referencias == 0) {
+        PistaNode *d = raiz->direita;
+        soltarPistas(raiz->esquerda);
+        free(raiz);
+        raiz = d;
+    }
+}
+
+/* inserirPersistentePrefixo: cada nó do caminho é copiado e o filho fora do caminho ganha
+   um pai a mais. As rotações do rebalanceamento só envolvem nós do caminho (o lado que
+   cresceu), que são cópias novas: a versão anterior nunca é tocada. */
+static PistaNode* inserirPersistentePrefixo(PistaNode *raiz, IdTexto pista, uint64_t prefixo) {
+    PistaNode *n = novaPistaContada();
+    if (raiz == NULL) {
+        n->prefixo = prefixo;
+        n->pista = pista;
+        n->ocorrencias = 1;
+        n->altura = 1;
+        n->tamanho = 1;
+        n->referencias = 1;
+        n->ocorrenciasSubarvore = 1;
+        n->esquerda = n->direita = NULL;
+        return n;
+    }
+    *n = *raiz;
+    n->referencias = 1;
+    if (pista == raiz->pista) {
+        n->ocorrencias++;
+        n->ocorrenciasSubarvore++;
+        reterPistas(n->esquerda);
+        reterPistas(n->direita);
+        return n;
+    } else if (prefixo != raiz->prefixo ? prefixo < raiz->prefixo
+                                        : strcmp(textoDe(pista) + 8, textoDe(raiz->pista) + 8) < 0) {
+        reterPistas(n->direita);
+        n->esquerda = inserirPersistentePrefixo(raiz->esquerda, pista, prefixo);
+    } else {
+        reterPistas(n->esquerda);
+        n->direita = inserirPersistentePrefixo(raiz->direita, pista, prefixo);
+    }
+    return balancearPista(n);
+}
+
+PistaNode* inserirPistaPersistente(PistaNode *raiz, IdTexto pista) {
+    if (pista == SEM_TEXTO) return reterPistas(raiz);
+    return inserirPersistentePrefixo(raiz, pista, prefixoTexto(textoDe(pista)));
+}
+
+PistaNode* copiarPistasPersistente(const PistaNode *raiz) {
+    if (raiz == NULL) return NULL;
+    PistaNode *n = novaPistaContada();
+    *n = *raiz;
+    n->referencias = 1;
+    n->esquerda = copiarPistasPersistente(raiz->esquerda);
+    n->direita = copiarPistasPersistente(raiz->direita);
+    return n;
+}
+
+/* ------------------ Carga de pistas em lote ------------------ */
+
+
+/* Trabalho de uma thread: ordenar um trecho ou intercalar dois já ordenados */
+typedef struct TarefaOrdenacao {
+    ChavePista *dados;
+    size_t n;
+    const ChavePista *outra;   // só na intercalação
+    size_t nOutra;
+    ChavePista *saida;         // idem
+    pthread_t thread;
+} TarefaOrdenacao;
+
+/* compararChaves: mesma ordem da árvore (ids iguais = textos iguais) */
+static int compararChaves(const void *a, const void *b) {
+    const ChavePista *x = (const ChavePista*) a, *y = (const ChavePista*) b;
+    if (x->prefixo != y->prefixo) return x->prefixo < y->prefixo ? -1 : 1;
+    if (x->pista == y->pista) return 0;
+    return strcmp(textoDe(x->pista) + 8, textoDe(y->pista) + 8);
+}
+
+/* agregarIguais: junta as repetidas (vizinhas após a ordenação) e devolve quantas restam */
+static size_t agregarIguais(ChavePista *v, size_t n) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (k && v[k - 1].pista == v[i].pista) v[k - 1].ocorrencias += v[i].ocorrencias;
+        else v[k++] = v[i];
+    }
+    return k;
+}
+
+/* intercalarChaves: une duas sequências ordenadas e sem repetidas, somando as comuns */
+static size_t intercalarChaves(const ChavePista *a, size_t na, const ChavePista *b, size_t nb,
+                               ChavePista *saida) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        int c = compararChaves(&a[i], &b[j]);
+        if (c < 0) saida[k++] = a[i++];
+        else if (c > 0) saida[k++] = b[j++];
+        else {
+            saida[k] = a[i++];
+            saida[k++].ocorrencias += b[j++].ocorrencias;
+        }
+    }
+    while (i < na) saida[k++] = a[i++];
+    while (j < nb) saida[k++] = b[j++];
+    return k;
+}
+
+static void* ordenarTrecho(void *arg) {
+    TarefaOrdenacao *t = (TarefaOrdenacao*) arg;
+    qsort(t->dados, t->n, sizeof(ChavePista), compararChaves);
+    t->n = agregarIguais(t->dados, t->n);
+    return NULL;
+}
+
+static void* intercalarTrecho(void *arg) {
+    TarefaOrdenacao *t = (TarefaOrdenacao*) arg;
+    t->n = intercalarChaves(t->dados, t->n, t->outra, t->nOutra, t->saida);
+    return NULL;
+}
+
+/* executarTarefas: uma thread por tarefa; a última roda na thread que chamou */
+static void executarTarefas(TarefaOrdenacao *t, size_t total, void *(*funcao)(void*)) {
+    for (size_t i = 0; i + 1 < total; i++) {
+        if (pthread_create(&t[i].thread, NULL, funcao, &t[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    funcao(&t[total - 1]);
+    for (size_t i = 0; i + 1 < total; i++) pthread_join(t[i].thread, NULL);
+}
+
+/* ordenarChaves: ordena e agrega o vetor no lugar; devolve quantas chaves distintas restam.
+   Lotes grandes: cada thread ordena um trecho, e os trechos são intercalados aos pares,
+   rodada a rodada, alternando entre o vetor e um auxiliar. */
+static size_t ordenarChaves(ChavePista *v, size_t n) {
+    size_t partes = n / ORDENACAO_POR_THREAD;
+    if (partes > 1) {
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        if (nucleos > 0 && partes > (size_t) nucleos) partes = (size_t) nucleos;
+    }
+    if (partes <= 1) {
+        qsort(v, n, sizeof(ChavePista), compararChaves);
+        return agregarIguais(v, n);
+    }
+
+    ESTAT_ALOCACAO(ALOC_PISTAS, 3);
+    ChavePista *aux = (ChavePista*) malloc(n * sizeof(ChavePista));
+    TarefaOrdenacao *t = (TarefaOrdenacao*) calloc(partes, sizeof(TarefaOrdenacao));
+    size_t *inicio = (size_t*) malloc(partes * sizeof(size_t));
+    if (!aux || !t || !inicio) { perror("malloc"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < partes; i++) {
+        inicio[i] = n * i / partes;
+        t[i].dados = v + inicio[i];
+        t[i].n = n * (i + 1) / partes - inicio[i];
+    }
+    executarTarefas(t, partes, ordenarTrecho);
+
+    // o trecho r ocupa [inicio[r], inicio[r] + t[r].n) em 'de'; a intercalação de um par
+    // cabe no espaço original do par, então o resultado começa no mesmo lugar em 'para'
+    ChavePista *de = v, *para = aux;
+    size_t trechos = partes;
+    while (trechos > 1) {
+        size_t pares = trechos / 2;
+        for (size_t p = 0; p < pares; p++) {   // t[p] só é reescrita depois de lidas t[2p] e t[2p+1]
+            size_t na = t[2 * p].n, nb = t[2 * p + 1].n;
+            t[p].dados = de + inicio[2 * p];
+            t[p].n = na;
+            t[p].outra = de + inicio[2 * p + 1];
+            t[p].nOutra = nb;
+            t[p].saida = para + inicio[2 * p];
+            inicio[p] = inicio[2 * p];
+        }
+        if (trechos % 2) {   // o trecho sem par só muda de vetor
+            size_t u = trechos - 1;
+            memcpy(para + inicio[u], de + inicio[u], t[u].n * sizeof(ChavePista));
+            t[pares].dados = para + inicio[u];
+            t[pares].n = t[u].n;
+            inicio[pares] = inicio[u];
+        }
+        executarTarefas(t, pares, intercalarTrecho);
+        ChavePista *troca = de; de = para; para = troca;
+        trechos = pares + trechos % 2;
+    }
+    size_t distintas = t[0].n;
+    if (de != v) memcpy(v, de, distintas * sizeof(ChavePista));
+    free(aux);
+    free(t);
+    free(inicio);
+    return distintas;
+}
+
+/* achatarPistas: transforma a árvore numa lista em ordem ligada por 'direita', com as
+   mesmas rotações de liberarPistas (sem pilha nem memória extra) */
+static PistaNode* achatarPistas(PistaNode *raiz) {
+    PistaNode *lista = NULL, **fim = &lista;
+    while (raiz) {
+        if (raiz->esquerda) {
+            PistaNode *e = raiz->esquerda;
+            raiz->esquerda = e->direita;
+            e->direita = raiz;
+            raiz = e;
+        } else {
+            *fim = raiz;
+            fim = &raiz->direita;
+            raiz = raiz->direita;
+        }
+    }
+    return lista;
+}
+
+/* montarDaLista: consome 'n' nós da lista em ordem e devolve a árvore perfeitamente
+   balanceada (subárvores diferem em no máximo um nó). A recursão desce log2(n) níveis. */
+static PistaNode* montarDaLista(PistaNode **lista, size_t n) {
+    if (n == 0) return NULL;
+    PistaNode *esquerda = montarDaLista(lista, n / 2);
+    PistaNode *raiz = *lista;
+    *lista = raiz->direita;
+    raiz->esquerda = esquerda;
+    raiz->direita = montarDaLista(lista, n - n / 2 - 1);
+    atualizarNo(raiz);
+    return raiz;
+}
+
+/* mesclarChaves: 'chaves' ordenadas e sem repetidas. Intercala a lista da árvore com o lote
+   (nós existentes são reaproveitados) e religa tudo balanceado. */
+PistaNode* mesclarChaves(PistaNode *raiz, const ChavePista *chaves, size_t m) {
+    PistaNode *velha = achatarPistas(raiz), *lista = NULL, **fim = &lista;
+    size_t total = 0, j = 0;
+    while (velha || j < m) {
+        PistaNode *n;
+        int c = !velha ? 1 : j == m ? -1
+              : velha->pista == chaves[j].pista ? 0
+              : velha->prefixo != chaves[j].prefixo ? (velha->prefixo < chaves[j].prefixo ? -1 : 1)
+              : strcmp(textoDe(velha->pista) + 8, textoDe(chaves[j].pista) + 8);
+        if (c <= 0) {
+            n = velha;
+            velha = velha->direita;
+            if (c == 0) n->ocorrencias += chaves[j++].ocorrencias;
+        } else {
+            n = (PistaNode*) alocarNo(sizeof(PistaNode), ALOC_PISTAS);
+            n->prefixo = chaves[j].prefixo;
+            n->pista = chaves[j].pista;
+            n->ocorrencias = chaves[j++].ocorrencias;
+            n->referencias = 1;
+        }
+        *fim = n;
+        fim = &n->direita;
+        total++;
+    }
+    *fim = NULL;
+    return montarDaLista(&lista, total);
+}
+
+PistaNode* montarPistas(const PistaContada *lote, size_t n) {
+    return mesclarPistas(NULL, lote, n);
+}
+
+/* mesclarPistas: com m pistas e uma árvore de t nós, m inserções custam ~m·log t e a
+   remontagem ~t + m; o lote só é ordenado quando a remontagem compensa. Uma AVL de
+   altura h tem pelo menos ~2^(0,69h) nós, o que dá t sem percorrer a árvore. */
+PistaNode* mesclarPistas(PistaNode *raiz, const PistaContada *lote, size_t n) {
+    int altura = alturaPista(raiz);
+    size_t minimoNos = altura ? (size_t) 1 << (altura * 2 / 3) : 0;
+    if (n * (size_t) altura < minimoNos) {
+        for (size_t i = 0; i < n; i++)
+            if (lote[i].pista != SEM_TEXTO && lote[i].ocorrencias > 0)
+                raiz = inserirPistaPrefixo(raiz, lote[i].pista, prefixoTexto(textoDe(lote[i].pista)),
+                                           lote[i].ocorrencias);
+        return raiz;
+    }
+
+    ESTAT_ALOCACAO(ALOC_PISTAS, 1);
+    ChavePista *chaves = (ChavePista*) malloc((n ? n : 1) * sizeof(ChavePista));
+    if (!chaves) { perror("malloc"); exit(EXIT_FAILURE); }
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (lote[i].pista == SEM_TEXTO || lote[i].ocorrencias <= 0) continue;
+        ChavePista c = { prefixoTexto(textoDe(lote[i].pista)), lote[i].pista, lote[i].ocorrencias };
+        chaves[m++] = c;
+    }
+    m = ordenarChaves(chaves, m);
+    raiz = mesclarChaves(raiz, chaves, m);
+    free(chaves);
+    return raiz;
+}
+
+/* empilharEsquerda: desce pela esquerda guardando o caminho (próximos a visitar) */
+static void empilharEsquerda(IteradorPistas *it, const PistaNode *n) {
+    for (; n; n = n->esquerda) it->pilha[it->topo++] = n;
+}
+
+void iniciarIterador(IteradorPistas *it, const PistaNode *raiz) {
+    it->topo = 0;
+    empilharEsquerda(it, raiz);
+}
+
+/* proximaPista: topo da pilha é o menor ainda não visitado; em seguida vem a
+   subárvore direita dele. Como a árvore é AVL, a pilha nunca passa da altura. */
+const PistaNode* proximaPista(IteradorPistas *it) {
+    if (it->topo == 0) return NULL;
+    const PistaNode *n = it->pilha[--it->topo];
+    empilharEsquerda(it, n->direita);
+    return n;
+}
+
+int visitarPistas(const PistaNode *raiz, VisitantePista visitar, void *contexto) {
+    IteradorPistas it;
+    iniciarIterador(&it, raiz);
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; )
+        if (visitar(n, contexto)) return 1;
+    return 0;
+}
+
+/* ------------------ Estatísticas de ordem ------------------ */
+
+/* compararComPista: texto (não necessariamente internado) contra o nó, pelo prefixo e só
+   então pelo resto. Prefixos iguais com texto de menos de 8 bytes = textos iguais. */
+static int compararComPista(const char *texto, uint64_t prefixo, size_t curto, const PistaNode *n) {
+    if (prefixo != n->prefixo) return prefixo < n->prefixo ? -1 : 1;
+    return curto ? 0 : strcmp(texto + 8, textoDe(n->pista) + 8);
+}
+
+/* selecionarPista: desce pelo tamanho da subárvore esquerda, que é a posição do nó nela */
+const PistaNode* selecionarPista(const PistaNode *raiz, size_t k) {
+    const PistaNode *n = raiz;
+    while (n) {
+        size_t e = tamanhoPista(n->esquerda);
+        if (k < e) {
+            n = n->esquerda;
+        } else if (k == e) {
+            return n;
+        } else {
+            k -= e + 1;
+            n = n->direita;
+        }
+    }
+    return NULL;
+}
+
+/* posicaoDaPista: ao seguir para a direita, o nó e a subárvore esquerda dele ficam antes */
+size_t posicaoDaPista(const PistaNode *raiz, const char *pista, uint64_t *ocorrencias) {
+    uint64_t prefixo = prefixoTexto(pista), soma = 0;
+    size_t curto = strnlen(pista, 8) < 8, antes = 0;
+    for (const PistaNode *n = raiz; n; ) {
+        int c = compararComPista(pista, prefixo, curto, n);
+        if (c <= 0) {
+            if (c == 0) {
+                antes += tamanhoPista(n->esquerda);
+                soma += ocorrenciasPista(n->esquerda);
+                break;
+            }
+            n = n->esquerda;
+        } else {
+            antes += tamanhoPista(n->esquerda) + 1;
+            soma += ocorrenciasPista(n->esquerda) + (uint64_t) n->ocorrencias;
+            n = n->direita;
+        }
+    }
+    if (ocorrencias) *ocorrencias = soma;
+    return antes;
+}
+
+/* contarIntervaloPistas: diferença de duas posições */
+size_t contarIntervaloPistas(const PistaNode *raiz, const char *de, const char *ate, uint64_t *ocorrencias) {
+    uint64_t somaDe = 0, somaAte = ocorrenciasPista(raiz);
+    size_t inicio = de ? posicaoDaPista(raiz, de, &somaDe) : 0;
+    size_t fim = ate ? posicaoDaPista(raiz, ate, &somaAte) : tamanhoPista(raiz);
+    if (fim < inicio) fim = inicio, somaAte = somaDe;
+    if (ocorrencias) *ocorrencias = somaAte - somaDe;
+    return fim - inicio;
+}
+
+/* posicionarIterador: no caminho até a k-ésima, empilha os nós em que se desce à esquerda
+   (ainda por visitar) e ela própria; quem fica para trás ao descer à direita já passou.
+   A pilha é a mesma que iniciarIterador teria depois de k chamadas a proximaPista. */
+void posicionarIterador(IteradorPistas *it, const PistaNode *raiz, size_t k) {
+    it->topo = 0;
+    for (const PistaNode *n = raiz; n; ) {
+        size_t e = tamanhoPista(n->esquerda);
+        if (k < e) {
+            it->pilha[it->topo++] = n;
+            n = n->esquerda;
+        } else if (k == e) {
+            it->pilha[it->topo++] = n;
+            return;
+        } else {
+            k -= e + 1;
+            n = n->direita;
+        }
+    }
+}
+
+size_t visitarPagina(const PistaNode *raiz, size_t inicio, size_t limite,
+                     VisitantePista visitar, void *contexto) {
+    IteradorPistas it;
+    posicionarIterador(&it, raiz, inicio);
+    size_t visitadas = 0;
+    for (const PistaNode *n; visitadas < limite && (n = proximaPista(&it)) != NULL; ) {
+        visitadas++;
+        if (visitar(n, contexto)) break;
+    }
+    return visitadas;
+}
+
+/* liberarPistas: libera BST de pistas (mesma técnica de rotações de liberarSalas) */
+void liberarPistas(PistaNode *raiz) {
+    while (raiz) {
+        if (raiz->esquerda) {
+            PistaNode *e = raiz->esquerda;
+            raiz->esquerda = e->direita;
+            e->direita = raiz;
+            raiz = e;
+        } else {
+            PistaNode *d = raiz->direita;
+            free(raiz);
+            raiz = d;
+        }
+    }
+}
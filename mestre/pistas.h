@@ -0,0 +1,107 @@
+/* pistas.h – árvore de pistas coletadas (AVL, persistente, estatísticas de ordem) */
+#ifndef MESTRE_PISTAS_H
+#define MESTRE_PISTAS_H
+
+#include "comum.h"
+
+#define ORDENACAO_POR_THREAD (1u << 16)  // pistas mínimas por thread na ordenação de lotes
+#define ALTURA_MAX_PISTAS 64         // pilha do iterador: AVL de altura 64 teria > 2^44 nós
+
+/* Nó da árvore AVL de pistas (armazenamos contagem para pistas repetidas) */
+typedef struct PistaNode {
+    uint64_t prefixo; // 8 primeiros bytes do texto em big-endian: comparar inteiros = strcmp
+    IdTexto pista;
+    int ocorrencias; // quantas vezes coletada
+    int altura;      // altura da subárvore (folha = 1), usada no balanceamento
+    uint32_t tamanho;              // nós da subárvore (inclusive este): k-ésima/posição em O(log n)
+    uint32_t referencias;          // árvore persistente: pais e versões que apontam para o nó
+    uint64_t ocorrenciasSubarvore; // soma de 'ocorrencias' na subárvore
+    struct PistaNode *esquerda;
+    struct PistaNode *direita;
+} PistaNode;
+
+/* Pista com sua contagem: entrada das cargas em lote (montarPistas / mesclarPistas) */
+typedef struct PistaContada {
+    IdTexto pista;
+    int ocorrencias;
+} PistaContada;
+
+/* Iterador em ordem da árvore de pistas: pilha explícita dos ancestrais pendentes */
+typedef struct IteradorPistas {
+    const PistaNode *pilha[ALTURA_MAX_PISTAS];
+    int topo;
+} IteradorPistas;
+
+/* Visitante em ordem: devolve != 0 para interromper o percurso */
+typedef int (*VisitantePista)(const PistaNode *no, void *contexto);
+
+/* Chave de ordenação do lote: o prefixo resolve quase todas as comparações */
+typedef struct ChavePista {
+    uint64_t prefixo;
+    IdTexto pista;
+    int ocorrencias;
+} ChavePista;
+
+/* inserirPista() / adicionarPista() – insere a pista coletada na árvore de pistas.
+   A árvore é AVL (ordem alfabética do texto): permanece balanceada mesmo com pistas chegando em ordem. */
+PistaNode* inserirPista(PistaNode *raiz, IdTexto pista);
+
+/* inserirPistaPersistente() – como inserirPista, mas 'raiz' continua valendo: a nova versão
+   copia só o caminho até a pista (O(log n) nós) e divide o resto com a anterior. Os nós
+   contam referências e vêm do malloc, fora da arena; a versão devolvida traz uma referência.
+   reterPistas() – mais uma referência à versão (devolve a própria raiz).
+   soltarPistas() – larga uma referência; nós que ficam sem nenhuma são liberados.
+   copiarPistasPersistente() – cópia contada de uma árvore comum, com a mesma forma, em O(n). */
+PistaNode* inserirPistaPersistente(PistaNode *raiz, IdTexto pista);
+PistaNode* reterPistas(PistaNode *raiz);
+void soltarPistas(PistaNode *raiz);
+PistaNode* copiarPistasPersistente(const PistaNode *raiz);
+
+/* montarPistas() – árvore de pistas a partir de um lote em qualquer ordem: ordena (em
+   paralelo nos lotes grandes), junta as repetidas somando 'ocorrencias' e liga os nós numa
+   árvore perfeitamente balanceada em O(n), em vez de n inserções.
+   mesclarPistas() – incorpora o lote a uma árvore existente, reaproveitando os nós dela
+   (O(n + m)); lotes pequenos diante da árvore entram por inserção. */
+PistaNode* montarPistas(const PistaContada *lote, size_t n);
+PistaNode* mesclarPistas(PistaNode *raiz, const PistaContada *lote, size_t n);
+
+/* iniciarIterador() / proximaPista() – percorre a árvore em ordem alfabética, um nó por
+   chamada (NULL no fim), sem recursão; o chamador pode parar a qualquer momento. */
+void iniciarIterador(IteradorPistas *it, const PistaNode *raiz);
+const PistaNode* proximaPista(IteradorPistas *it);
+
+/* visitarPistas() – chama 'visitar' em ordem para cada nó até ele devolver != 0.
+   Retorna 1 se o percurso foi interrompido, 0 se chegou ao fim. */
+int visitarPistas(const PistaNode *raiz, VisitantePista visitar, void *contexto);
+
+/* selecionarPista() – a k-ésima pista em ordem alfabética (a partir de 0), NULL se k passa
+   do total. posicaoDaPista() – quantas pistas distintas vêm antes do texto (a posição dele,
+   se coletado). contarIntervaloPistas() – pistas distintas em [de, ate) (NULL = sem limite).
+   Todas em O(log n) pelos tamanhos das subárvores; 'ocorrencias', se não for NULL, recebe a
+   soma das ocorrências correspondente. */
+const PistaNode* selecionarPista(const PistaNode *raiz, size_t k);
+size_t posicaoDaPista(const PistaNode *raiz, const char *pista, uint64_t *ocorrencias);
+size_t contarIntervaloPistas(const PistaNode *raiz, const char *de, const char *ate, uint64_t *ocorrencias);
+
+/* posicionarIterador() – como iniciarIterador, mas a primeira pista devolvida é a k-ésima
+   (O(log n), sem percorrer as anteriores). visitarPagina() – visita em ordem só as pistas
+   [inicio, inicio + limite), parando antes se 'visitar' devolver != 0; retorna quantas. */
+void posicionarIterador(IteradorPistas *it, const PistaNode *raiz, size_t k);
+size_t visitarPagina(const PistaNode *raiz, size_t inicio, size_t limite,
+                     VisitantePista visitar, void *contexto);
+
+/* liberarPistas() – libera a árvore comum (quando não veio de uma arena). */
+void liberarPistas(PistaNode *raiz);
+
+/* alturaPista() / tamanhoPista() – altura e número de nós da subárvore (0 para NULL). */
+int alturaPista(const PistaNode *n);
+uint32_t tamanhoPista(const PistaNode *n);
+
+/* prefixoTexto() – até 8 bytes do texto em big-endian, completados com zero: comparar os
+   inteiros dá a ordem do strcmp nesses bytes. */
+uint64_t prefixoTexto(const char *texto);
+
+/* mesclarChaves() – como mesclarPistas, com as chaves já ordenadas e sem repetidas. */
+PistaNode* mesclarChaves(PistaNode *raiz, const ChavePista *chaves, size_t m);
+
+#endif
@@ -0,0 +1,202 @@
+/* processo.c – processo do caso: implicações ponderadas compiladas em bitsets, pontuadas
+   com AND + popcount (kernels escalar/POPCNT/AVX2) */
+
+#include "processo.h"
+#include "associacoes.h"
+#include "hash.h"
+
+/* Kernel de pontuação: contagens[p] = popcount(coletadas & plano p) para 'totalPlanos'
+   planos consecutivos de 'palavras' palavras (múltiplo de PALAVRAS_POR_VETOR). Só contam
+   bits, então escalar, POPCNT e AVX2 dão exatamente o mesmo resultado. */
+typedef void (*KernelPontuacao)(const uint64_t *coletadas, const uint64_t *planos, size_t palavras,
+                                uint32_t totalPlanos, uint64_t *contagens);
+
+/* contarPlanos: corpo comum dos kernels escalares (o popcount vira instrução com POPCNT) */
+static inline __attribute__((always_inline))
+void contarPlanos(const uint64_t *coletadas, const uint64_t *planos, size_t palavras,
+                  uint32_t totalPlanos, uint64_t *contagens) {
+    for (uint32_t p = 0; p < totalPlanos; p++, planos += palavras) {
+        uint64_t c = 0;
+        for (size_t w = 0; w < palavras; w++) c += (uint64_t) __builtin_popcountll(coletadas[w] & planos[w]);
+        contagens[p] = c;
+    }
+}
+
+static void contarEscalar(const uint64_t *coletadas, const uint64_t *planos, size_t palavras,
+                          uint32_t totalPlanos, uint64_t *contagens) {
+    contarPlanos(coletadas, planos, palavras, totalPlanos, contagens);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PONTUACAO_COM_X86 1
+__attribute__((target("popcnt")))
+static void contarPopcnt(const uint64_t *coletadas, const uint64_t *planos, size_t palavras,
+                         uint32_t totalPlanos, uint64_t *contagens) {
+    contarPlanos(coletadas, planos, palavras, totalPlanos, contagens);
+}
+
+/* bitsPorByte: popcount de cada byte por tabela de nibbles (vpshufb) */
+__attribute__((target("avx2")))
+static inline __m256i bitsPorByte(__m256i v) {
+    const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i baixo = _mm256_shuffle_epi8(tabela, _mm256_and_si256(v, nibble));
+    __m256i alto = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_add_epi8(baixo, alto);
+}
+
+/* contarAvx2: as contagens por byte (até 8 por vetor) acumulam 31 vetores antes de
+   transbordar; só então são somadas em 64 bits com vpsadbw */
+__attribute__((target("avx2")))
+static void contarAvx2(const uint64_t *coletadas, const uint64_t *planos, size_t palavras,
+                       uint32_t totalPlanos, uint64_t *contagens) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (uint32_t p = 0; p < totalPlanos; p++, planos += palavras) {
+        __m256i soma = zero;
+        for (size_t w = 0; w < palavras; ) {
+            size_t fim = w + 31 * PALAVRAS_POR_VETOR < palavras ? w + 31 * PALAVRAS_POR_VETOR : palavras;
+            __m256i bytes = zero;
+            for (; w < fim; w += PALAVRAS_POR_VETOR) {
+                __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (coletadas + w)),
+                                             _mm256_loadu_si256((const __m256i*) (planos + w)));
+                bytes = _mm256_add_epi8(bytes, bitsPorByte(v));
+            }
+            soma = _mm256_add_epi64(soma, _mm256_sad_epu8(bytes, zero));
+        }
+        uint64_t faixas[4];
+        _mm256_storeu_si256((__m256i*) faixas, soma);
+        contagens[p] = faixas[0] + faixas[1] + faixas[2] + faixas[3];
+    }
+}
+#endif
+
+/* kernel em uso: promovido por escolherKernelPontuacao() ao melhor que a CPU suporta */
+static KernelPontuacao kernelPontuacao = contarEscalar;
+
+/* escolherKernelPontuacao: detecção da CPU, feita ao compilar o processo (antes das sessões) */
+static void escolherKernelPontuacao(void) {
+#ifdef PONTUACAO_COM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) kernelPontuacao = contarPopcnt;
+    if (__builtin_cpu_supports("avx2")) kernelPontuacao = contarAvx2;
+#endif
+}
+
+void iniciarProcesso(Processo *processo) {
+    memset(processo, 0, sizeof(*processo));
+    inicializarHash(&processo->indicePistas);
+    processo->indicePistas.arena = NULL;   // vive tanto quanto o processo, fora das arenas
+}
+
+void registrarImplicacao(Processo *processo, IdTexto pista, IdTexto suspeito, uint32_t peso) {
+    if (pista == SEM_TEXTO || suspeito == SEM_TEXTO) return;
+    if (processo->totalImplicacoes == processo->capImplicacoes) {
+        size_t cap = processo->capImplicacoes ? processo->capImplicacoes * 2 : 64;
+        ESTAT_ALOCACAO(ALOC_PROCESSO, 1);
+        Implicacao *v = (Implicacao*) realloc(processo->implicacoes, cap * sizeof(Implicacao));
+        if (!v) { perror("realloc"); exit(EXIT_FAILURE); }
+        processo->implicacoes = v;
+        processo->capImplicacoes = cap;
+    }
+    Implicacao im = { pista, suspeito, peso < PESO_MAXIMO ? peso : PESO_MAXIMO,
+                      (uint32_t) processo->totalImplicacoes };
+    processo->implicacoes[processo->totalImplicacoes++] = im;
+}
+
+/* compararImplicacoes: pares vizinhos, na ordem de chegada */
+static int compararImplicacoes(const void *a, const void *b) {
+    const Implicacao *x = (const Implicacao*) a, *y = (const Implicacao*) b;
+    if (x->pista != y->pista) return x->pista < y->pista ? -1 : 1;
+    if (x->suspeito != y->suspeito) return x->suspeito < y->suspeito ? -1 : 1;
+    return (x->ordem > y->ordem) - (x->ordem < y->ordem);
+}
+
+/* compilarProcesso: um par por (pista, suspeito), numeração densa e os planos de bits.
+   Os planos de um suspeito ficam contíguos: pontuá-lo é uma varredura sequencial. */
+void compilarProcesso(Processo *processo) {
+    Implicacao *v = processo->implicacoes;
+    size_t n = processo->totalImplicacoes, unicas = 0;
+    if (n) qsort(v, n, sizeof(Implicacao), compararImplicacoes);
+
+    TabelaHash indiceSuspeitos;   // suspeito -> número + 1
+    inicializarHash(&indiceSuspeitos);
+    indiceSuspeitos.arena = NULL;
+    uint32_t capSuspeitos = 0, maior = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i + 1 < n && v[i + 1].pista == v[i].pista && v[i + 1].suspeito == v[i].suspeito) continue;
+        if (v[i].peso == 0) continue;   // a última palavra sobre o par o descartou
+        if (encontrarSuspeitoId(&processo->indicePistas, v[i].pista) == SEM_TEXTO)
+            inserirNaHashId(&processo->indicePistas, v[i].pista, ++processo->totalPistas);
+        if (encontrarSuspeitoId(&indiceSuspeitos, v[i].suspeito) == SEM_TEXTO) {
+            if (processo->totalSuspeitos == capSuspeitos) {
+                capSuspeitos = capSuspeitos ? capSuspeitos * 2 : 16;
+                ESTAT_ALOCACAO(ALOC_PROCESSO, 1);
+                IdTexto *s = (IdTexto*) realloc(processo->suspeitos, capSuspeitos * sizeof(IdTexto));
+                if (!s) { perror("realloc"); exit(EXIT_FAILURE); }
+                processo->suspeitos = s;
+            }
+            processo->suspeitos[processo->totalSuspeitos++] = v[i].suspeito;
+            inserirNaHashId(&indiceSuspeitos, v[i].suspeito, processo->totalSuspeitos);
+        }
+        if (v[i].peso > maior) maior = v[i].peso;
+        v[unicas++] = v[i];
+    }
+
+    const size_t bitsPorVetor = 64 * PALAVRAS_POR_VETOR;
+    processo->planos = maior ? 32 - (uint32_t) __builtin_clz(maior) : 0;
+    processo->palavras = (processo->totalPistas + bitsPorVetor - 1) / bitsPorVetor * PALAVRAS_POR_VETOR;
+    size_t porSuspeito = (1 + processo->planos) * processo->palavras;
+    ESTAT_ALOCACAO(ALOC_PROCESSO, 1);
+    processo->bits = (uint64_t*) calloc(processo->totalSuspeitos * porSuspeito + 1, sizeof(uint64_t));
+    if (!processo->bits) { perror("calloc"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < unicas; i++) {
+        uint32_t pista = encontrarSuspeitoId(&processo->indicePistas, v[i].pista) - 1;
+        uint32_t sus = encontrarSuspeitoId(&indiceSuspeitos, v[i].suspeito) - 1;
+        uint64_t *plano = processo->bits + sus * porSuspeito + pista / 64, bit = 1ULL << (pista % 64);
+        plano[0] |= bit;
+        for (uint32_t b = 0; b < processo->planos; b++)
+            if (v[i].peso >> b & 1) plano[(1 + b) * processo->palavras] |= bit;
+    }
+    liberarHash(&indiceSuspeitos);
+    free(v);
+    processo->implicacoes = NULL;
+    processo->totalImplicacoes = unicas;   // daqui em diante: pares no processo
+    processo->capImplicacoes = 0;
+    escolherKernelPontuacao();
+}
+
+void liberarProcesso(Processo *processo) {
+    free(processo->implicacoes);
+    free(processo->suspeitos);
+    free(processo->bits);
+    liberarHash(&processo->indicePistas);
+    memset(processo, 0, sizeof(*processo));
+}
+
+/* numeroDaPista: número da pista no processo (UINT32_MAX se ela não implica ninguém) */
+uint32_t numeroDaPista(const Processo *processo, IdTexto pista) {
+    IdTexto n = encontrarSuspeitoId(&processo->indicePistas, pista);
+    return n != SEM_TEXTO ? n - 1 : UINT32_MAX;
+}
+
+/* pontuarComKernel: contagens de todos os planos de cada suspeito; o peso é a soma das
+   contagens dos planos de bits, cada uma deslocada pela posição do bit */
+static void pontuarComKernel(const Processo *processo, const uint64_t *coletadas,
+                             PontuacaoSuspeito *saida, KernelPontuacao kernel) {
+    uint64_t contagens[1 + PLANOS_PESO];
+    size_t porSuspeito = (1 + processo->planos) * processo->palavras;
+    for (uint32_t s = 0; s < processo->totalSuspeitos; s++) {
+        saida[s].suspeito = processo->suspeitos[s];
+        saida[s].pistas = 0;
+        saida[s].peso = 0;
+        if (!coletadas) continue;
+        kernel(coletadas, processo->bits + s * porSuspeito, processo->palavras, 1 + processo->planos, contagens);
+        saida[s].pistas = (uint32_t) contagens[0];
+        for (uint32_t b = 0; b < processo->planos; b++) saida[s].peso += contagens[1 + b] << b;
+    }
+}
+
+void pontuarSuspeitos(const Processo *processo, const uint64_t *coletadas, PontuacaoSuspeito *saida) {
+    pontuarComKernel(processo, coletadas, saida, kernelPontuacao);
+}
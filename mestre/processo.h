@@ -0,0 +1,61 @@
+/* processo.h – processo do caso: implicações ponderadas pista -> suspeitos */
+#ifndef MESTRE_PROCESSO_H
+#define MESTRE_PROCESSO_H
+
+#include "tabela.h"
+
+#define PESO_MAXIMO 255              // peso de uma implicação no processo
+#define PLANOS_PESO 8                // planos de bits que PESO_MAXIMO ocupa
+#define PESO_ASSOCIACAO 1            // peso com que cada "associa" entra no processo
+#define PALAVRAS_POR_VETOR 4         // bitsets do processo arredondados a 256 bits (um registro AVX2)
+
+/* Implicação registrada no processo: a pista pesa 'peso' contra o suspeito */
+typedef struct Implicacao {
+    IdTexto pista;
+    IdTexto suspeito;
+    uint32_t peso;      // 0 desfaz o par (ex.: uma associação que o caso descarta)
+    uint32_t ordem;     // chegada: a última implicação de um par prevalece
+} Implicacao;
+
+/* Processo do caso: relação muitos-para-muitos pista -> suspeitos com pesos. As
+   implicações são registradas aos poucos e compiladas uma vez em bitsets sobre as pistas
+   implicadas (numeradas de 0 a totalPistas - 1): por suspeito, um plano de presença e um
+   plano por bit do peso. A pontuação de todos os suspeitos é então AND + popcount de cada
+   plano com o bitset das pistas coletadas, sem consulta por pista. Só leitura depois de
+   compilado. */
+typedef struct Processo {
+    Implicacao *implicacoes;    // registro até compilarProcesso (liberado lá)
+    size_t totalImplicacoes, capImplicacoes;
+    TabelaHash indicePistas;    // pista -> número da pista + 1
+    IdTexto *suspeitos;         // número do suspeito -> id
+    uint32_t totalPistas, totalSuspeitos;
+    uint32_t planos;            // planos de peso em uso (bits do maior peso)
+    size_t palavras;            // palavras de 64 bits por plano (múltiplo de PALAVRAS_POR_VETOR)
+    uint64_t *bits;             // [suspeito][presença, bit 0, bit 1, ...][palavras]
+} Processo;
+
+/* Pontuação de um suspeito no processo */
+typedef struct PontuacaoSuspeito {
+    IdTexto suspeito;
+    uint32_t pistas;    // pistas coletadas distintas que o implicam
+    uint64_t peso;      // soma dos pesos dessas implicações
+} PontuacaoSuspeito;
+
+/* iniciarProcesso() / registrarImplicacao() – processo vazio e uma implicação pista ->
+   suspeito com peso (0..PESO_MAXIMO; a última de cada par prevalece, 0 desfaz o par).
+   compilarProcesso() – numera pistas e suspeitos e monta os bitsets, uma vez, antes das
+   sessões; daí em diante o processo é só lido. liberarProcesso() – descarta tudo. */
+void iniciarProcesso(Processo *processo);
+void registrarImplicacao(Processo *processo, IdTexto pista, IdTexto suspeito, uint32_t peso);
+void compilarProcesso(Processo *processo);
+void liberarProcesso(Processo *processo);
+
+/* pontuarSuspeitos() – pontua todos os suspeitos do processo contra o bitset de pistas
+   coletadas ('coletadas' NULL = nenhuma), em processo->totalSuspeitos posições de 'saida'
+   (na ordem dos números de suspeito). Usa o kernel de popcount escolhido para a CPU. */
+void pontuarSuspeitos(const Processo *processo, const uint64_t *coletadas, PontuacaoSuspeito *saida);
+
+/* numeroDaPista() – número da pista no processo compilado (UINT32_MAX se não implica ninguém). */
+uint32_t numeroDaPista(const Processo *processo, IdTexto pista);
+
+#endif
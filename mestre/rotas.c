@@ -0,0 +1,167 @@
+/* rotas.c – rotas: numeração em pré-ordem, ancestral comum em O(1) e pista nova mais próxima */
+
+#include "rotas.h"
+#include "pistas.h"
+#include "sessao.h"
+#include "textos.h"
+
+/* maisRasa: das duas salas, a de menor profundidade (empate: a de menor número) */
+static uint32_t maisRasa(const MapaRotas *r, uint32_t a, uint32_t b) {
+    return r->profundidade[b] < r->profundidade[a] ? b : a;
+}
+
+/* rasaNoTrecho: sala mais rasa de [de, ate] varrendo número a número */
+static uint32_t rasaNoTrecho(const MapaRotas *r, uint32_t de, uint32_t ate) {
+    uint32_t melhor = de;
+    for (uint32_t i = de + 1; i <= ate; i++) melhor = maisRasa(r, melhor, i);
+    return melhor;
+}
+
+void construirRotas(const Mansao *mansao, MapaRotas *rotas) {
+    memset(rotas, 0, sizeof(*rotas));
+    uint32_t total = contarSalas(mansao);
+    if (total == 0) return;
+
+    // vetores por sala num único bloco (as posições primeiro, pelo alinhamento)
+    size_t tamBloco = (size_t) total * (sizeof(PosicaoSala) + 5 * sizeof(uint32_t));
+    ESTAT_ALOCACAO(ALOC_ROTAS, 4);
+    unsigned char *bloco = (unsigned char*) malloc(tamBloco);
+    // pendentes: sala a numerar + número do pai e lado (pilha; a direita entra antes)
+    PosicaoSala *pend = (PosicaoSala*) malloc(total * sizeof(PosicaoSala));
+    uint32_t *paiPend = (uint32_t*) malloc(total * sizeof(uint32_t));
+    unsigned char *ladoPend = (unsigned char*) malloc(total);
+    if (!bloco || !pend || !paiPend || !ladoPend) { perror("malloc"); exit(EXIT_FAILURE); }
+    rotas->posicoes = (PosicaoSala*) bloco;
+    rotas->pai = (uint32_t*) (bloco + (size_t) total * sizeof(PosicaoSala));
+    rotas->filhos = rotas->pai + total;
+    rotas->profundidade = rotas->filhos + 2 * (size_t) total;
+    rotas->pistas = (IdTexto*) (rotas->profundidade + total);
+
+    uint32_t topo = 0, prox = 0;
+    PosicaoSala p = posicaoInicial(mansao);
+    if (posicaoValida(mansao, p)) { pend[topo] = p; paiPend[topo] = SALA_NENHUMA; ladoPend[topo++] = 0; }
+    while (topo > 0 && prox < total) {   // 'total' limita também mapas malformados
+        uint32_t u = prox++, pai = paiPend[--topo];
+        PosicaoSala atual = pend[topo];
+        rotas->posicoes[u] = atual;
+        rotas->pai[u] = pai;
+        rotas->profundidade[u] = pai == SALA_NENHUMA ? 0 : rotas->profundidade[pai] + 1;
+        rotas->pistas[u] = pistaDaPosicao(mansao, atual);
+        rotas->filhos[2 * (size_t) u] = rotas->filhos[2 * (size_t) u + 1] = SALA_NENHUMA;
+        if (pai != SALA_NENHUMA) rotas->filhos[2 * (size_t) pai + ladoPend[topo]] = u;
+        for (int lado = 1; lado >= 0 && topo < total; lado--) {
+            PosicaoSala f = filhoDaPosicao(mansao, atual, lado);
+            if (posicaoValida(mansao, f)) { pend[topo] = f; paiPend[topo] = u; ladoPend[topo++] = (unsigned char) lado; }
+        }
+    }
+    free(pend);
+    free(paiPend);
+    free(ladoPend);
+    rotas->total = prox;
+
+    // tabela esparsa: nível 0 = mais rasa de cada bloco; nível k junta dois do nível k - 1
+    uint32_t blocos = (prox + ROTAS_BLOCO - 1) / ROTAS_BLOCO, niveis = 1;
+    while ((1u << niveis) <= blocos) niveis++;
+    ESTAT_ALOCACAO(ALOC_ROTAS, 1);
+    rotas->minimos = (uint32_t*) malloc((size_t) niveis * blocos * sizeof(uint32_t));
+    if (!rotas->minimos) { perror("malloc"); exit(EXIT_FAILURE); }
+    rotas->blocos = blocos;
+    rotas->niveis = niveis;
+    for (uint32_t b = 0; b < blocos; b++) {
+        uint32_t fim = (b + 1) * ROTAS_BLOCO < prox ? (b + 1) * ROTAS_BLOCO : prox;
+        rotas->minimos[b] = rasaNoTrecho(rotas, b * ROTAS_BLOCO, fim - 1);
+    }
+    for (uint32_t k = 1; k < niveis; k++) {
+        const uint32_t *ant = rotas->minimos + (size_t) (k - 1) * blocos;
+        uint32_t *nivel = rotas->minimos + (size_t) k * blocos;
+        for (uint32_t b = 0; b + (1u << k) <= blocos; b++)
+            nivel[b] = maisRasa(rotas, ant[b], ant[b + (1u << (k - 1))]);
+    }
+}
+
+void liberarRotas(MapaRotas *rotas) {
+    free(rotas->posicoes);   // bloco de todos os vetores por sala
+    free(rotas->minimos);
+    memset(rotas, 0, sizeof(*rotas));
+}
+
+/* rasaEntre: sala mais rasa de [de, ate]: pontas varridas, blocos inteiros pela tabela */
+static uint32_t rasaEntre(const MapaRotas *r, uint32_t de, uint32_t ate) {
+    uint32_t bde = de / ROTAS_BLOCO, bate = ate / ROTAS_BLOCO;
+    if (bate - bde < 2) return rasaNoTrecho(r, de, ate);
+    uint32_t melhor = maisRasa(r, rasaNoTrecho(r, de, (bde + 1) * ROTAS_BLOCO - 1),
+                               rasaNoTrecho(r, bate * ROTAS_BLOCO, ate));
+    uint32_t b1 = bde + 1, n = bate - b1, k = 0;   // blocos inteiros [b1, bate)
+    while ((2u << k) <= n) k++;
+    const uint32_t *nivel = r->minimos + (size_t) k * r->blocos;
+    melhor = maisRasa(r, melhor, maisRasa(r, nivel[b1], nivel[bate - (1u << k)]));
+    return melhor;
+}
+
+uint32_t ancestralComum(const MapaRotas *rotas, uint32_t a, uint32_t b) {
+    if (a == b) return a;
+    if (a > b) { uint32_t t = a; a = b; b = t; }
+    return rotas->pai[rasaEntre(rotas, a + 1, b)];
+}
+
+uint32_t distanciaSalas(const MapaRotas *rotas, uint32_t a, uint32_t b) {
+    uint32_t c = ancestralComum(rotas, a, b);
+    return rotas->profundidade[a] + rotas->profundidade[b] - 2 * rotas->profundidade[c];
+}
+
+uint32_t rotaEntreSalas(const MapaRotas *rotas, uint32_t de, uint32_t para, char *passos, size_t cap) {
+    uint32_t c = ancestralComum(rotas, de, para);
+    uint32_t subir = rotas->profundidade[de] - rotas->profundidade[c];
+    uint32_t total = subir + rotas->profundidade[para] - rotas->profundidade[c];
+    size_t limite = cap ? cap - 1 : 0;
+    for (uint32_t i = 0; i < subir && i < limite; i++) passos[i] = 'v';
+    // descida escrita de trás para frente, subindo de 'para' até o ancestral comum
+    for (uint32_t u = para, i = total; u != c; u = rotas->pai[u]) {
+        i--;
+        if (i < limite) passos[i] = rotas->filhos[2 * (size_t) rotas->pai[u]] == u ? 'e' : 'd';
+    }
+    if (cap) passos[total < limite ? total : limite] = '\0';
+    return total;
+}
+
+/* pistaColetada: busca da pista na árvore da sessão (prefixo primeiro, como na inserção) */
+static int pistaColetada(const PistaNode *n, IdTexto pista) {
+    uint64_t prefixo = prefixoTexto(textoDe(pista));
+    while (n && n->pista != pista) {
+        int esquerda = prefixo != n->prefixo ? prefixo < n->prefixo
+                                             : strcmp(textoDe(pista) + 8, textoDe(n->pista) + 8) < 0;
+        n = esquerda ? n->esquerda : n->direita;
+    }
+    return n != NULL;
+}
+
+uint32_t pistaNovaMaisProxima(const MapaRotas *rotas, const Sessao *sessao, uint32_t de) {
+    if (de >= rotas->total) return SALA_NENHUMA;
+    // fila de (sala, vizinho de onde veio): numa árvore isso dispensa marcar visitadas
+    size_t cap = 64, inicio = 0, fim = 0;
+    ESTAT_ALOCACAO(ALOC_ROTAS, 1);
+    uint32_t *fila = (uint32_t*) malloc(cap * 2 * sizeof(uint32_t));
+    if (!fila) { perror("malloc"); exit(EXIT_FAILURE); }
+    fila[0] = de; fila[1] = SALA_NENHUMA; fim = 1;
+    uint32_t achada = SALA_NENHUMA;
+    while (inicio < fim) {
+        uint32_t u = fila[2 * inicio], veio = fila[2 * inicio + 1];
+        inicio++;
+        IdTexto pista = rotas->pistas[u];
+        if (pista != SEM_TEXTO && !pistaColetada(sessao->raizPistas, pista)) { achada = u; break; }
+        uint32_t vizinhos[3] = { rotas->filhos[2 * (size_t) u], rotas->filhos[2 * (size_t) u + 1], rotas->pai[u] };
+        for (int i = 0; i < 3; i++) {
+            if (vizinhos[i] == SALA_NENHUMA || vizinhos[i] == veio) continue;
+            if (fim == cap) {
+                cap *= 2;
+                ESTAT_ALOCACAO(ALOC_ROTAS, 1);
+                fila = (uint32_t*) realloc(fila, cap * 2 * sizeof(uint32_t));
+                if (!fila) { perror("realloc"); exit(EXIT_FAILURE); }
+            }
+            fila[2 * fim] = vizinhos[i]; fila[2 * fim + 1] = u;
+            fim++;
+        }
+    }
+    free(fila);
+    return achada;
+}
@@ -0,0 +1,47 @@
+/* rotas.h – rotas entre salas (--dicas) */
+#ifndef MESTRE_ROTAS_H
+#define MESTRE_ROTAS_H
+
+#include "mansao.h"
+
+#define ROTAS_BLOCO 32               // salas por bloco na tabela esparsa do ancestral comum
+#define ROTA_EXIBIDA 64              // passos mostrados na dica de rota (o resto vira "...")
+
+/* definida em sessao.h */
+typedef struct Sessao Sessao;
+
+/* Índice de rotas da mansão, montado uma vez por construirRotas(). As salas são numeradas
+   em pré-ordem (a mesma numeração dos instantâneos), então a subárvore de u ocupa números
+   consecutivos a partir de u e o ancestral comum de u < v é o pai da sala mais rasa em
+   (u, v]. Uma tabela esparsa sobre as salas mais rasas de cada bloco de ROTAS_BLOCO
+   responde esse mínimo em O(1) com memória O(n). Só leitura depois de montado. */
+typedef struct MapaRotas {
+    uint32_t total;
+    PosicaoSala *posicoes;    // número -> posição no layout da mansão
+    uint32_t *pai;            // SALA_NENHUMA na entrada
+    uint32_t *filhos;         // [2u] esquerda, [2u + 1] direita (SALA_NENHUMA se não houver)
+    uint32_t *profundidade;   // entrada = 0
+    IdTexto *pistas;          // pista de cada sala: a busca por pistas não toca no mapa
+    uint32_t *minimos;        // nível k, bloco b: sala mais rasa dos blocos [b, b + 2^k)
+    uint32_t blocos, niveis;
+} MapaRotas;
+
+/* construirRotas() – numera as salas em pré-ordem e monta pais, profundidades e a tabela
+   do ancestral comum em O(n). Percorre o mapa inteiro; por isso o programa recusa --dicas
+   com --paginada. */
+void construirRotas(const Mansao *mansao, MapaRotas *rotas);
+void liberarRotas(MapaRotas *rotas);
+
+/* ancestralComum() / distanciaSalas() – consultas O(1) entre números de sala. */
+uint32_t ancestralComum(const MapaRotas *rotas, uint32_t a, uint32_t b);
+uint32_t distanciaSalas(const MapaRotas *rotas, uint32_t a, uint32_t b);
+
+/* rotaEntreSalas() – menor caminho de 'de' até 'para' como movimentos ('v' sobe ao pai,
+   'e'/'d' descem). Grava até cap - 1 passos e '\0'; retorna o total de passos. */
+uint32_t rotaEntreSalas(const MapaRotas *rotas, uint32_t de, uint32_t para, char *passos, size_t cap);
+
+/* pistaNovaMaisProxima() – sala mais próxima de 'de' cuja pista a sessão ainda não
+   coletou (busca em largura pela árvore sem direção); SALA_NENHUMA se não houver. */
+uint32_t pistaNovaMaisProxima(const MapaRotas *rotas, const Sessao *sessao, uint32_t de);
+
+#endif
@@ -0,0 +1,340 @@
+/* sessao.c – sessão de investigação: coleta, contadores e ranking por suspeito, histórico
+   de desfazer */
+
+#include "sessao.h"
+#include "associacoes.h"
+#include "memoria.h"
+#include "textos.h"
+
+void iniciarSessao(Sessao *sessao) {
+    sessao->raizPistas = NULL;
+    sessao->triePistas = NULL;
+    sessao->evidencias = NULL;
+    sessao->ranking = NULL;
+    sessao->heapSuspeitos = NULL;
+    sessao->tamHeap = 0;
+    sessao->relogio = 0;
+    sessao->capEvidencias = 0;
+    sessao->maisProvavel = SEM_TEXTO;
+    sessao->atual.sala = NULL;
+    sessao->atual.indice = SALA_NENHUMA;
+    sessao->numeroAtual = SALA_NENHUMA;
+    memset(&sessao->historico, 0, sizeof(sessao->historico));
+    sessao->roteiro = NULL;
+    sessao->saida = NULL;
+    sessao->rotas = NULL;
+    sessao->processo = NULL;
+    sessao->coletadas = NULL;
+    sessao->gravarEm = NULL;
+    sessao->suspensa = 0;
+}
+
+void liberarSessao(Sessao *sessao) {
+    HistoricoSessao *h = &sessao->historico;
+    if (h->ativo) {
+        soltarPistas(sessao->raizPistas);
+        for (uint32_t i = 0; i < h->totalMarcos; i++) soltarPistas(h->marcos[i].raiz);
+        free(h->marcos);
+        free(h->diario);
+    } else if (!arenaAtual) {
+        liberarPistas(sessao->raizPistas);
+        liberarTrie(sessao->triePistas);
+    }
+    free(sessao->evidencias);   // libera também ranking e heap
+    free(sessao->coletadas);
+    iniciarSessao(sessao);
+}
+
+/* reservarSuspeito: garante lugar para o id nos vetores por suspeito. Contadores, ranking
+   e heap dividem um único bloco: uma alocação por crescimento. */
+void reservarSuspeito(Sessao *sessao, IdTexto sus) {
+    if (sus < sessao->capEvidencias) return;
+    uint32_t antiga = sessao->capEvidencias, cap = antiga ? antiga : 16;
+    while (cap <= sus) cap *= 2;
+    ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+    int *ev = (int*) calloc(cap, sizeof(int) + sizeof(RankingSuspeito) + sizeof(IdTexto));
+    if (!ev) { perror("calloc"); exit(EXIT_FAILURE); }
+    RankingSuspeito *rk = (RankingSuspeito*) (ev + cap);
+    IdTexto *hp = (IdTexto*) (rk + cap);
+    if (antiga) {
+        memcpy(ev, sessao->evidencias, antiga * sizeof(int));
+        memcpy(rk, sessao->ranking, antiga * sizeof(RankingSuspeito));
+        memcpy(hp, sessao->heapSuspeitos, sessao->tamHeap * sizeof(IdTexto));
+        free(sessao->evidencias);
+    }
+    sessao->evidencias = ev;
+    sessao->ranking = rk;
+    sessao->heapSuspeitos = hp;
+    sessao->capEvidencias = cap;
+}
+
+/* precedeNoRanking: mais evidências primeiro; no empate, quem chegou antes à contagem */
+static int precedeNoRanking(const Sessao *sessao, IdTexto a, IdTexto b) {
+    int ea = sessao->evidencias[a], eb = sessao->evidencias[b];
+    return ea != eb ? ea > eb : sessao->ranking[a].marca < sessao->ranking[b].marca;
+}
+
+/* registrarEvidencia: o contador de 'sus' acabou de crescer. Como as chaves só sobem,
+   basta subir o suspeito no heap (ou inseri-lo no fim e subir): O(log n). */
+void registrarEvidencia(Sessao *sessao, IdTexto sus) {
+    RankingSuspeito *rk = sessao->ranking;
+    IdTexto *heap = sessao->heapSuspeitos;
+    rk[sus].marca = ++sessao->relogio;
+    uint32_t i = rk[sus].posicao ? rk[sus].posicao - 1 : sessao->tamHeap++;
+    while (i > 0) {
+        uint32_t pai = (i - 1) / 2;
+        if (!precedeNoRanking(sessao, sus, heap[pai])) break;
+        heap[i] = heap[pai];
+        rk[heap[i]].posicao = i + 1;
+        i = pai;
+    }
+    heap[i] = sus;
+    rk[sus].posicao = i + 1;
+}
+
+/* marcarColetada: liga o bit da pista no bitset da sessão (pistas fora do processo não pesam) */
+void marcarColetada(Sessao *sessao, IdTexto pista) {
+    const Processo *p = sessao->processo;
+    uint32_t n = numeroDaPista(p, pista);
+    if (n == UINT32_MAX) return;
+    if (!sessao->coletadas) {
+        ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+        sessao->coletadas = (uint64_t*) calloc(p->palavras, sizeof(uint64_t));
+        if (!sessao->coletadas) { perror("calloc"); exit(EXIT_FAILURE); }
+    }
+    sessao->coletadas[n / 64] |= 1ULL << (n % 64);
+}
+
+/* anotarDiario: sem ponto de retorno não há o que desfazer, então nada é guardado */
+static void anotarDiario(Sessao *sessao, RegistroDiario registro) {
+    HistoricoSessao *h = &sessao->historico;
+    if (h->totalMarcos == 0) return;
+    if (h->totalDiario == h->capDiario) {
+        h->capDiario = h->capDiario ? h->capDiario * 2 : 16;
+        ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+        h->diario = (RegistroDiario*) realloc(h->diario, h->capDiario * sizeof(RegistroDiario));
+        if (!h->diario) { perror("realloc"); exit(EXIT_FAILURE); }
+    }
+    h->diario[h->totalDiario++] = registro;
+}
+
+/* coletarPista: mantém os contadores incrementalmente a cada nova ocorrência */
+void coletarPista(Sessao *sessao, const TabelaHash *hash, IdTexto pista) {
+    if (pista == SEM_TEXTO) return;
+    RegistroDiario registro = { pista, SEM_TEXTO, 0, sessao->maisProvavel };
+    if (sessao->historico.ativo) {
+        // a versão anterior só sobrevive se um ponto de retorno (ou ramo) a retiver
+        PistaNode *nova = inserirPistaPersistente(sessao->raizPistas, pista);
+        soltarPistas(sessao->raizPistas);
+        sessao->raizPistas = nova;
+    } else {
+        sessao->raizPistas = inserirPista(sessao->raizPistas, pista);
+        // a trie só existe depois da primeira consulta de prefixo; até lá a coleta não paga por ela
+        if (sessao->triePistas) sessao->triePistas = inserirNaTrie(sessao->triePistas, pista);
+    }
+    if (sessao->processo) marcarColetada(sessao, pista);
+
+    IdTexto sus = encontrarSuspeitoId(hash, pista);
+    if (sus != SEM_TEXTO) {
+        reservarSuspeito(sessao, sus);
+        registro.suspeito = sus;
+        registro.marca = sessao->ranking[sus].marca;
+        sessao->evidencias[sus]++;
+        registrarEvidencia(sessao, sus);
+        // contadores só crescem (fora do desfazer): basta comparar com o líder atual
+        if (sessao->maisProvavel == SEM_TEXTO ||
+            sessao->evidencias[sus] > sessao->evidencias[sessao->maisProvavel])
+            sessao->maisProvavel = sus;
+    }
+    if (sessao->historico.ativo) anotarDiario(sessao, registro);
+}
+
+/* ------------------ Histórico da sessão ------------------ */
+
+/* acomodarNoHeap: põe 'sus' no lugar i do heap, subindo ou descendo até a ordem valer */
+static void acomodarNoHeap(Sessao *sessao, uint32_t i, IdTexto sus) {
+    RankingSuspeito *rk = sessao->ranking;
+    IdTexto *heap = sessao->heapSuspeitos;
+    while (i > 0) {
+        uint32_t pai = (i - 1) / 2;
+        if (!precedeNoRanking(sessao, sus, heap[pai])) break;
+        heap[i] = heap[pai];
+        rk[heap[i]].posicao = i + 1;
+        i = pai;
+    }
+    for (;;) {
+        uint32_t f = 2 * i + 1;
+        if (f >= sessao->tamHeap) break;
+        if (f + 1 < sessao->tamHeap && precedeNoRanking(sessao, heap[f + 1], heap[f])) f++;
+        if (!precedeNoRanking(sessao, heap[f], sus)) break;
+        heap[i] = heap[f];
+        rk[heap[i]].posicao = i + 1;
+        i = f;
+    }
+    heap[i] = sus;
+    rk[sus].posicao = i + 1;
+}
+
+/* retirarEvidencia: desfaz registrarEvidencia. O suspeito volta à marca anterior; sem
+   evidências ele sai do heap e o último ocupa o lugar dele. */
+static void retirarEvidencia(Sessao *sessao, IdTexto sus, uint32_t marca) {
+    RankingSuspeito *rk = sessao->ranking;
+    uint32_t i = rk[sus].posicao - 1;
+    sessao->evidencias[sus]--;
+    rk[sus].marca = marca;
+    if (sessao->evidencias[sus] == 0) {
+        rk[sus].posicao = 0;
+        sus = sessao->heapSuspeitos[--sessao->tamHeap];
+        if (i == sessao->tamHeap) return;
+    }
+    acomodarNoHeap(sessao, i, sus);
+}
+
+/* pistaNaVersao: a pista está na árvore? (posição do texto e o nó que a ocupa) */
+static int pistaNaVersao(const PistaNode *raiz, IdTexto pista) {
+    const PistaNode *n = selecionarPista(raiz, posicaoDaPista(raiz, textoDe(pista), NULL));
+    return n && n->pista == pista;
+}
+
+void ativarHistorico(Sessao *sessao) {
+    if (sessao->historico.ativo) return;
+    PistaNode *copia = copiarPistasPersistente(sessao->raizPistas);
+    if (!arenaAtual) {
+        liberarPistas(sessao->raizPistas);
+        liberarTrie(sessao->triePistas);
+    }
+    sessao->raizPistas = copia;
+    sessao->triePistas = NULL;
+    sessao->historico.ativo = 1;
+}
+
+void marcarPasso(Sessao *sessao) {
+    HistoricoSessao *h = &sessao->historico;
+    if (!h->ativo) return;
+    if (h->totalMarcos == h->capMarcos) {
+        h->capMarcos = h->capMarcos ? h->capMarcos * 2 : 16;
+        ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+        h->marcos = (MarcoSessao*) realloc(h->marcos, h->capMarcos * sizeof(MarcoSessao));
+        if (!h->marcos) { perror("realloc"); exit(EXIT_FAILURE); }
+    }
+    MarcoSessao m = { reterPistas(sessao->raizPistas), sessao->atual, sessao->numeroAtual, h->totalDiario };
+    h->marcos[h->totalMarcos++] = m;
+}
+
+/* desfazerPasso: o diário é desfeito de trás para frente, então cada registro encontra os
+   contadores exatamente como os deixou */
+int desfazerPasso(Sessao *sessao) {
+    HistoricoSessao *h = &sessao->historico;
+    if (h->totalMarcos == 0) return -1;
+    MarcoSessao m = h->marcos[--h->totalMarcos];
+    PistaNode *descartada = sessao->raizPistas;
+    sessao->raizPistas = m.raiz;   // a referência do ponto passa para a sessão
+    while (h->totalDiario > m.registros) {
+        RegistroDiario r = h->diario[--h->totalDiario];
+        if (r.suspeito != SEM_TEXTO) retirarEvidencia(sessao, r.suspeito, r.marca);
+        sessao->maisProvavel = r.maisProvavel;
+        uint32_t n = sessao->coletadas ? numeroDaPista(sessao->processo, r.pista) : UINT32_MAX;
+        if (n != UINT32_MAX && !pistaNaVersao(sessao->raizPistas, r.pista))
+            sessao->coletadas[n / 64] &= ~(1ULL << (n % 64));
+    }
+    soltarPistas(descartada);
+    sessao->atual = m.atual;
+    sessao->numeroAtual = m.numero;
+    return 0;
+}
+
+/* duplicarBloco: cópia em memória nova dos vetores da sessão */
+static void* duplicarBloco(const void *origem, size_t bytes) {
+    ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) { perror("malloc"); exit(EXIT_FAILURE); }
+    memcpy(p, origem, bytes);
+    return p;
+}
+
+/* bifurcarSessao: uma origem sem histórico tem a árvore copiada uma vez (ela não é
+   persistente); depois disso os dois ramos só dividem nós */
+void bifurcarSessao(const Sessao *origem, Sessao *ramo) {
+    const HistoricoSessao *h = &origem->historico;
+    *ramo = *origem;
+    ramo->raizPistas = h->ativo ? reterPistas(origem->raizPistas) : copiarPistasPersistente(origem->raizPistas);
+    ramo->triePistas = NULL;
+    ramo->historico.ativo = 1;
+    if (origem->capEvidencias) {
+        // mesmo bloco de reservarSuspeito; só quem está no heap tem contador e marca não
+        // nulos, então basta copiar esses: O(suspeitos com evidência), não O(maior id)
+        uint32_t cap = origem->capEvidencias;
+        ESTAT_ALOCACAO(ALOC_SESSAO, 1);
+        int *ev = (int*) calloc(cap, sizeof(int) + sizeof(RankingSuspeito) + sizeof(IdTexto));
+        if (!ev) { perror("calloc"); exit(EXIT_FAILURE); }
+        RankingSuspeito *rk = (RankingSuspeito*) (ev + cap);
+        IdTexto *hp = (IdTexto*) (rk + cap);
+        for (uint32_t i = 0; i < origem->tamHeap; i++) {
+            IdTexto sus = hp[i] = origem->heapSuspeitos[i];
+            ev[sus] = origem->evidencias[sus];
+            rk[sus] = origem->ranking[sus];
+        }
+        ramo->evidencias = ev;
+        ramo->ranking = rk;
+        ramo->heapSuspeitos = hp;
+    }
+    if (origem->coletadas)
+        ramo->coletadas = (uint64_t*) duplicarBloco(origem->coletadas,
+                                                    origem->processo->palavras * sizeof(uint64_t));
+    HistoricoSessao *hr = &ramo->historico;
+    hr->marcos = NULL;
+    hr->diario = NULL;
+    hr->capMarcos = hr->totalMarcos;
+    hr->capDiario = hr->totalDiario;
+    if (hr->totalMarcos) {
+        hr->marcos = (MarcoSessao*) duplicarBloco(h->marcos, hr->totalMarcos * sizeof(MarcoSessao));
+        for (uint32_t i = 0; i < hr->totalMarcos; i++) reterPistas(hr->marcos[i].raiz);
+    }
+    if (hr->totalDiario) hr->diario = (RegistroDiario*) duplicarBloco(h->diario, hr->totalDiario * sizeof(RegistroDiario));
+}
+
+int evidenciasDe(const Sessao *sessao, IdTexto suspeito) {
+    return suspeito != SEM_TEXTO && suspeito < sessao->capEvidencias ? sessao->evidencias[suspeito] : 0;
+}
+
+IdTexto suspeitoMaisProvavel(const Sessao *sessao) {
+    return sessao->maisProvavel;
+}
+
+/* suspeitosMaisProvaveis: o k-ésimo maior está entre os filhos dos k-1 já retirados, então
+   um heap auxiliar de candidatos (posições do heap da sessão) nunca passa de k+1 */
+size_t suspeitosMaisProvaveis(const Sessao *sessao, IdTexto *saida, size_t k) {
+    if (k > sessao->tamHeap) k = sessao->tamHeap;
+    if (k == 0) return 0;
+    const IdTexto *heap = sessao->heapSuspeitos;
+    uint32_t *cand = (uint32_t*) malloc((k + 1) * sizeof(uint32_t));
+    if (!cand) { perror("malloc"); exit(EXIT_FAILURE); }
+    size_t total = 0;
+    cand[total++] = 0;
+    for (size_t r = 0; r < k; r++) {
+        // retira o melhor candidato
+        uint32_t melhor = cand[0], ultimo = cand[--total];
+        size_t i = 0;
+        for (;;) {
+            size_t f = 2 * i + 1;
+            if (f >= total) break;
+            if (f + 1 < total && precedeNoRanking(sessao, heap[cand[f + 1]], heap[cand[f]])) f++;
+            if (!precedeNoRanking(sessao, heap[cand[f]], heap[ultimo])) break;
+            cand[i] = cand[f];
+            i = f;
+        }
+        if (total) cand[i] = ultimo;
+        saida[r] = heap[melhor];
+        // os filhos dele no heap da sessão viram candidatos
+        for (uint32_t filho = 2 * melhor + 1; filho <= 2 * melhor + 2 && filho < sessao->tamHeap; filho++) {
+            size_t j = total++;
+            while (j > 0 && precedeNoRanking(sessao, heap[filho], heap[cand[(j - 1) / 2]])) {
+                cand[j] = cand[(j - 1) / 2];
+                j = (j - 1) / 2;
+            }
+            cand[j] = filho;
+        }
+    }
+    free(cand);
+    return k;
+}
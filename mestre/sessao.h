@@ -0,0 +1,113 @@
+/* sessao.h – estado de uma investigação */
+#ifndef MESTRE_SESSAO_H
+#define MESTRE_SESSAO_H
+
+#include "pistas.h"
+#include "trie.h"
+#include "rotas.h"
+#include "processo.h"
+
+/* Saída de uma sessão: acumulada num buffer e gravada de uma vez, ou descartada */
+typedef struct Saida {
+    char *buf;
+    size_t tam;
+    size_t cap;
+    int silenciosa;           // não formata nada (reprodução em massa)
+} Saida;
+
+/* Lugar de um suspeito no ranking da sessão */
+typedef struct RankingSuspeito {
+    uint32_t posicao;   // índice no heap + 1 (0 = ainda sem evidências)
+    uint32_t marca;     // momento da última evidência: no empate, quem chegou antes lidera
+} RankingSuspeito;
+
+/* Ponto de retorno do histórico: uma versão da árvore (com referência própria) e a sala */
+typedef struct MarcoSessao {
+    PistaNode *raiz;
+    PosicaoSala atual;
+    uint32_t numero;      // número em pré-ordem da sala (com rotas)
+    uint32_t registros;   // tamanho do diário quando o ponto foi marcado
+} MarcoSessao;
+
+/* Registro do diário: o que uma coleta mudou fora da árvore, para desfazer */
+typedef struct RegistroDiario {
+    IdTexto pista;          // pista coletada
+    IdTexto suspeito;       // quem ganhou a evidência (SEM_TEXTO se ninguém)
+    uint32_t marca;         // marca anterior do suspeito no ranking
+    IdTexto maisProvavel;   // líder antes da coleta
+} RegistroDiario;
+
+/* Histórico de desfazer: pontos de retorno e o diário das mudanças feitas desde o primeiro */
+typedef struct HistoricoSessao {
+    int ativo;              // árvore persistente (nós contados, fora da arena) em vez da mutável
+    MarcoSessao *marcos;
+    uint32_t totalMarcos, capMarcos;
+    RegistroDiario *diario;
+    uint32_t totalDiario, capDiario;
+} HistoricoSessao;
+
+/* Estado privado de uma investigação: pistas coletadas e contadores por suspeito.
+   Os contadores são atualizados na coleta, então a acusação não percorre a árvore. */
+typedef struct Sessao {
+    PistaNode *raizPistas;
+    NoTrie *triePistas;       // as mesmas pistas por prefixo (NULL = montada na 1ª consulta)
+    int *evidencias;          // id do suspeito -> ocorrências de pistas que apontam para ele
+    RankingSuspeito *ranking; // id do suspeito -> lugar no heap (mesmo bloco de 'evidencias')
+    IdTexto *heapSuspeitos;   // heap máximo por (evidências, chegada); idem
+    uint32_t tamHeap;
+    uint32_t relogio;         // evidências registradas até agora (gera as marcas)
+    uint32_t capEvidencias;
+    IdTexto maisProvavel;     // suspeito com mais evidências até agora (SEM_TEXTO se nenhum)
+    PosicaoSala atual;        // sala onde a exploração parou (inválida = começa na entrada)
+    uint32_t numeroAtual;     // número em pré-ordem dessa sala (com rotas)
+    const MapaRotas *rotas;   // habilita voltar e a dica de rota (NULL = só e/d/s)
+    const Processo *processo; // pontuação ponderada (NULL = só os contadores)
+    uint64_t *coletadas;      // bits por número de pista do processo (alocado na primeira)
+    HistoricoSessao historico; // desfazer/bifurcar (inativo = árvore mutável e trie)
+    const char *gravarEm;     // com --salvar: (g) grava o instantâneo no meio da exploração
+    int suspensa;             // a exploração parou em (g): sem fase final, retomar depois
+    const char *roteiro;      // movimentos ('e', 'd', 's'); NULL = lê do teclado
+    Saida *saida;             // NULL = imprime direto no stdout
+} Sessao;
+
+/* iniciarSessao() / liberarSessao() – estado vazio de investigação e sua limpeza
+   (a árvore de pistas só é liberada aqui quando não veio de uma arena). */
+void iniciarSessao(Sessao *sessao);
+void liberarSessao(Sessao *sessao);
+
+/* coletarPista() – registra a pista na árvore e soma uma evidência ao suspeito associado. */
+void coletarPista(Sessao *sessao, const TabelaHash *hash, IdTexto pista);
+
+/* ativarHistorico() – troca a árvore de pistas da sessão pela persistente e liga o desfazer;
+   a trie deixa de ser mantida (prefixos passam a ser consultados na árvore). Chamar antes
+   de explorar (depois de retomarSessao, se houver).
+   marcarPasso() – guarda um ponto de retorno (versão da árvore, sala e contadores) em O(1).
+   desfazerPasso() – volta ao último ponto: a árvore volta em O(1), os nós só da versão
+   descartada são liberados e os contadores são revertidos pelo diário. -1 se não há pontos.
+   bifurcarSessao() – 'ramo' vira uma sessão independente no estado de 'origem', histórico
+   incluído; a árvore é dividida em O(1) e dos contadores só os suspeitos com evidências
+   são copiados (mais o bitset do processo, quando existe). */
+void ativarHistorico(Sessao *sessao);
+void marcarPasso(Sessao *sessao);
+int desfazerPasso(Sessao *sessao);
+void bifurcarSessao(const Sessao *origem, Sessao *ramo);
+
+/* evidenciasDe() – quantas ocorrências de pistas coletadas apontam para o suspeito, em O(1). */
+int evidenciasDe(const Sessao *sessao, IdTexto suspeito);
+
+/* suspeitoMaisProvavel() – suspeito com mais evidências até agora, em O(1). */
+IdTexto suspeitoMaisProvavel(const Sessao *sessao);
+
+/* suspeitosMaisProvaveis() – os até 'k' suspeitos com mais evidências, em ordem, lidos do
+   heap da sessão em O(k log k). Empates favorecem quem chegou antes à contagem (o mesmo
+   critério de suspeitoMaisProvavel). Retorna quantos foram gravados em 'saida'. */
+size_t suspeitosMaisProvaveis(const Sessao *sessao, IdTexto *saida, size_t k);
+
+/* reservarSuspeito() – garante lugar para o id nos vetores por suspeito.
+   registrarEvidencia() – sobe o suspeito no ranking depois de o seu contador crescer.
+   marcarColetada() – liga o bit da pista no bitset do processo da sessão. */
+void reservarSuspeito(Sessao *sessao, IdTexto sus);
+void registrarEvidencia(Sessao *sessao, IdTexto sus);
+void marcarColetada(Sessao *sessao, IdTexto pista);
+
+#endif
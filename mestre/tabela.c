@@ -0,0 +1,199 @@
+/* tabela.c – tabela hash Robin Hood (hashes em vetor separado) e filtro de Bloom em blocos */
+
+#include "tabela.h"
+#include "hash.h"
+#include "textos.h"
+
+/* sais do filtro de Bloom: cada palavra do bloco escolhe o seu bit com um multiplicador */
+static const uint32_t SAIS_FILTRO[8] = {
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+    0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+};
+
+/* blocoDoFiltro: os bits altos do hash escolhem o bloco (os baixos já escolhem o slot) */
+static _Atomic uint64_t* blocoDoFiltro(const FiltroBloom *f, unsigned long h) {
+    return f->palavras + 8 * (((uint64_t) h >> 32) & (f->blocos - 1));
+}
+
+static uint64_t bitDoFiltro(unsigned long h, int palavra) {
+    return 1ULL << (((uint32_t) h * SAIS_FILTRO[palavra]) >> 26);
+}
+
+void marcarFiltro(FiltroBloom *f, unsigned long h) {
+    _Atomic uint64_t *b = blocoDoFiltro(f, h);
+    for (int i = 0; i < 8; i++) atomic_fetch_or_explicit(&b[i], bitDoFiltro(h, i), memory_order_relaxed);
+}
+
+/* passaNoFiltro: 0 = a chave certamente não está na tabela */
+int passaNoFiltro(const FiltroBloom *f, unsigned long h) {
+    const _Atomic uint64_t *b = blocoDoFiltro(f, h);
+    uint64_t faltando = 0;
+    for (int i = 0; i < 8; i++)
+        faltando |= bitDoFiltro(h, i) & ~atomic_load_explicit(&b[i], memory_order_relaxed);
+    ESTAT_FILTRO(filtroConsultas);
+    if (faltando) ESTAT_FILTRO(filtroRejeitadas);
+    return faltando == 0;
+}
+
+/* blocosDoFiltro: um bloco de 512 bits para cada FILTRO_SLOTS_POR_BLOCO slots */
+size_t blocosDoFiltro(size_t capacidade) {
+    return capacidade > FILTRO_SLOTS_POR_BLOCO ? capacidade / FILTRO_SLOTS_POR_BLOCO : 1;
+}
+
+/* distância do slot ocupado 'i' até o seu slot ideal */
+size_t distanciaSlot(const TabelaHash *t, size_t i) {
+    return (i - (t->hashes[i] & (t->capacidade - 1))) & (t->capacidade - 1);
+}
+
+/* slot vazio compartilhado: a tabela recém-criada aponta para ele em vez de alocar */
+static unsigned long slotVazio[1] = { 0 };
+
+/* alocarSlots: numa arena, os vetores antigos ficam nela até o reset
+   (como a capacidade dobra, o desperdício total fica abaixo do tamanho final) */
+void alocarSlots(TabelaHash *t, size_t capacidade) {
+    if (t->arena) {
+        t->hashes = (unsigned long*) arenaAlocar(t->arena, capacidade * sizeof(unsigned long));
+        t->entradas = (HashEntry*) arenaAlocar(t->arena, capacidade * sizeof(HashEntry));
+    } else {
+        ESTAT_ALOCACAO(ALOC_HASH, 2);
+        t->hashes = (unsigned long*) malloc(capacidade * sizeof(unsigned long));
+        t->entradas = (HashEntry*) malloc(capacidade * sizeof(HashEntry));
+        if (!t->hashes || !t->entradas) { perror("malloc"); exit(EXIT_FAILURE); }
+    }
+    memset(t->hashes, 0, capacidade * sizeof(unsigned long));
+    t->capacidade = capacidade;
+    t->tamanho = 0;
+}
+
+/* posicionarEntrada: inserção Robin Hood de uma entrada que sabidamente não está na tabela */
+static void posicionarEntrada(TabelaHash *t, unsigned long h, HashEntry e) {
+    size_t mascara = t->capacidade - 1;
+    size_t i = h & mascara, dist = 0;
+    while (t->hashes[i] != 0) {
+        size_t existente = distanciaSlot(t, i);
+        if (existente < dist) {
+            // a entrada residente está mais perto de casa: cede o lugar
+            unsigned long th = t->hashes[i]; t->hashes[i] = h; h = th;
+            HashEntry te = t->entradas[i]; t->entradas[i] = e; e = te;
+            dist = existente;
+        }
+        i = (i + 1) & mascara;
+        dist++;
+    }
+    t->hashes[i] = h;
+    t->entradas[i] = e;
+    t->tamanho++;
+}
+
+/* montarFiltro: filtro do tamanho da capacidade atual, com as chaves presentes (na arena,
+   o filtro anterior fica nela até o reset, como os slots) */
+static void montarFiltro(TabelaHash *t) {
+    size_t blocos = blocosDoFiltro(t->capacidade), tam = blocos * 8 * sizeof(uint64_t);
+    if (!t->arena) free((void*) t->filtro.palavras);
+    if (t->arena) {
+        uintptr_t p = (uintptr_t) arenaAlocar(t->arena, tam + 63);
+        t->filtro.palavras = (_Atomic uint64_t*) ((p + 63) & ~(uintptr_t) 63);
+    } else {
+        ESTAT_ALOCACAO(ALOC_HASH, 1);
+        t->filtro.palavras = (_Atomic uint64_t*) aligned_alloc(64, tam);
+        if (!t->filtro.palavras) { perror("aligned_alloc"); exit(EXIT_FAILURE); }
+    }
+    memset((void*) t->filtro.palavras, 0, tam);
+    t->filtro.blocos = blocos;
+    for (size_t i = 0; i < t->capacidade; i++)
+        if (t->hashes[i] != 0) marcarFiltro(&t->filtro, t->hashes[i]);
+}
+
+/* redimensionarHash: realoca com a nova capacidade e reinsere tudo */
+static void redimensionarHash(TabelaHash *t, size_t capacidade) {
+    TabelaHash antiga = *t;
+    alocarSlots(t, capacidade);
+    for (size_t i = 0; i < antiga.capacidade; i++)
+        if (antiga.hashes[i] != 0) posicionarEntrada(t, antiga.hashes[i], antiga.entradas[i]);
+    if (!antiga.arena && antiga.hashes != slotVazio) {
+        free(antiga.hashes);
+        free(antiga.entradas);
+    }
+    if (t->filtro.palavras) montarFiltro(t);
+}
+
+/* inserirSlot: cresce a tabela se preciso e posiciona uma entrada nova */
+void inserirSlot(TabelaHash *t, unsigned long h, HashEntry e) {
+    if ((t->tamanho + 1) * HASH_CARGA_DEN > t->capacidade * HASH_CARGA_NUM)
+        redimensionarHash(t, t->capacidade < HASH_CAPACIDADE_INICIAL ? HASH_CAPACIDADE_INICIAL
+                                                                     : t->capacidade * 2);
+    posicionarEntrada(t, h, e);
+}
+
+/* removerSlot: esvazia o slot 'i' e puxa uma posição para trás os seguintes que estão
+   fora de casa (remoção Robin Hood sem lápides: as buscas continuam parando cedo) */
+void removerSlot(TabelaHash *t, size_t i) {
+    size_t mascara = t->capacidade - 1;
+    size_t j = (i + 1) & mascara;
+    while (t->hashes[j] != 0 && distanciaSlot(t, j) > 0) {
+        t->hashes[i] = t->hashes[j];
+        t->entradas[i] = t->entradas[j];
+        i = j;
+        j = (j + 1) & mascara;
+    }
+    t->hashes[i] = 0;
+    t->tamanho--;
+}
+
+/* reservarHash: garante espaço para 'n' entradas sem crescer no meio de uma carga */
+void reservarHash(TabelaHash *t, size_t n) {
+    size_t cap = t->capacidade < HASH_CAPACIDADE_INICIAL ? HASH_CAPACIDADE_INICIAL : t->capacidade;
+    while (n * HASH_CARGA_DEN > cap * HASH_CARGA_NUM) cap *= 2;
+    if (cap != t->capacidade) redimensionarHash(t, cap);
+}
+
+/* buscarSlot: índice do slot, ou -1 se ausente (para cedo pelo critério Robin Hood).
+   Com 'texto' != NULL compara o texto internado da chave; senão compara o id 'chave'. */
+long buscarSlot(const TabelaHash *t, unsigned long h, IdTexto chave, const char *texto) {
+    size_t mascara = t->capacidade - 1;
+    size_t i = h & mascara, dist = 0;
+    while (t->hashes[i] != 0 && distanciaSlot(t, i) >= dist) {
+        if (t->hashes[i] == h) {
+            IdTexto id = t->entradas[i].pista;
+            if (texto ? strcmp(textoDe(id), texto) == 0 : id == chave) {
+                ESTAT_CONSULTA(dist + 1);
+                return (long) i;
+            }
+        }
+        i = (i + 1) & mascara;
+        dist++;
+    }
+    ESTAT_CONSULTA(dist + 1);
+    return -1;
+}
+
+/* inicializarHash: tabela vazia de um slot (o compartilhado), sem alocação */
+void inicializarHash(TabelaHash *hash) {
+    hash->arena = arenaAtual;
+    hash->hashes = slotVazio;
+    hash->entradas = NULL;
+    hash->capacidade = 1;
+    hash->tamanho = 0;
+    hash->fixas = 0;
+    hash->concorrente = NULL;
+    hash->filtro.palavras = NULL;
+    hash->filtro.blocos = 0;
+}
+
+void ativarFiltro(TabelaHash *hash) {
+    if (!hash->filtro.palavras) montarFiltro(hash);
+}
+
+/* liberarHash: libera os vetores de slots da tabela hash (se não vierem de arena) */
+void liberarHash(TabelaHash *hash) {
+    if (!hash->arena && hash->hashes != slotVazio) {
+        free(hash->hashes);
+        free(hash->entradas);
+    }
+    if (!hash->arena) free((void*) hash->filtro.palavras);
+    hash->filtro.palavras = NULL;
+    hash->filtro.blocos = 0;
+    hash->hashes = NULL;
+    hash->entradas = NULL;
+    hash->capacidade = hash->tamanho = 0;
+}
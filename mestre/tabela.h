@@ -0,0 +1,78 @@
+/* tabela.h – tabela hash Robin Hood e filtro de Bloom em blocos */
+#ifndef MESTRE_TABELA_H
+#define MESTRE_TABELA_H
+
+#include "memoria.h"
+
+#define HASH_CAPACIDADE_INICIAL 16   // potência de 2; a tabela dobra conforme a carga
+#define HASH_CARGA_NUM 7             // fator de carga máximo = 7/8
+#define HASH_CARGA_DEN 8
+#define FILTRO_SLOTS_POR_BLOCO 32    // slots da tabela por bloco do filtro (16 bits por slot)
+#define FILTRO_ENTRADAS_MINIMAS 8192 // associações a partir das quais a mansão usa o filtro
+
+/* definida em concorrente.h */
+typedef struct TabelaConcorrente TabelaConcorrente;
+
+/* Entrada na tabela hash - mapeia pista -> suspeito (ambos por id) */
+typedef struct HashEntry {
+    IdTexto pista;
+    IdTexto suspeito;
+} HashEntry;
+
+/* Filtro de Bloom em blocos de uma linha de cache (8 palavras de 64 bits). Cada chave
+   marca um bit em cada palavra do seu bloco, então a consulta lê uma linha só. Bits só são
+   ligados, nunca desligados: palavras atômicas deixam a tabela concorrente marcar com
+   leitores consultando. */
+typedef struct FiltroBloom {
+    _Atomic uint64_t *palavras;   // 8 por bloco, alinhadas a 64 bytes (NULL = desligado)
+    size_t blocos;                // potência de 2
+} FiltroBloom;
+
+/* Tabela hash com endereçamento aberto (Robin Hood).
+   Os hashes ficam num vetor separado das entradas: a sondagem percorre
+   só esse vetor compacto e só olha a entrada quando o hash coincide. */
+typedef struct TabelaHash {
+    unsigned long *hashes;  // hash em cache de cada slot (0 = slot vazio)
+    HashEntry *entradas;    // paralelo a hashes
+    size_t capacidade;      // sempre potência de 2
+    size_t tamanho;         // slots ocupados
+    Arena *arena;           // arena dona dos vetores (NULL = malloc/free)
+    int fixas;              // consulta também o hash perfeito de associacoes_fixas.h
+    TabelaConcorrente *concorrente;   // parte dinâmica movida para cá (NULL = usa os slots)
+    FiltroBloom filtro;     // pistas da parte dinâmica (só nas tabelas de associações)
+} TabelaHash;
+
+/* inicializarHash() – prepara uma tabela vazia (na arena da thread, se houver). Nada é
+   alocado até a primeira inserção, que já reserva HASH_CAPACIDADE_INICIAL slots. */
+void inicializarHash(TabelaHash *hash);
+
+/* ativarFiltro() – põe um filtro de Bloom na frente da parte dinâmica da tabela de
+   associações: encontrarSuspeitoId rejeita a maioria das pistas sem suspeito numa leitura
+   de 64 bytes. Acompanha inserções e crescimento; não usar em tabelas com remoção. */
+void ativarFiltro(TabelaHash *hash);
+
+/* liberarHash() – devolve os vetores da tabela (quando não vieram de uma arena). */
+void liberarHash(TabelaHash *hash);
+
+/* Operações sobre os slots, usadas pelos módulos que montam tabelas próprias (textos,
+   associações, mansão paginada, processo).
+   alocarSlots() – vetores de 'capacidade' slots vazios (na arena da tabela, se houver).
+   reservarHash() – garante espaço para 'n' entradas sem crescer no meio de uma carga.
+   inserirSlot() – posiciona uma entrada nova com hash 'h' (nunca 0), crescendo se preciso.
+   buscarSlot() – índice do slot ou -1; com 'texto' != NULL compara o texto internado da
+   chave, senão o id 'chave'. removerSlot() – remoção Robin Hood, sem lápides.
+   distanciaSlot() – distância do slot ocupado 'i' ao seu slot ideal. */
+void alocarSlots(TabelaHash *t, size_t capacidade);
+void reservarHash(TabelaHash *t, size_t n);
+void inserirSlot(TabelaHash *t, unsigned long h, HashEntry e);
+long buscarSlot(const TabelaHash *t, unsigned long h, IdTexto chave, const char *texto);
+void removerSlot(TabelaHash *t, size_t i);
+size_t distanciaSlot(const TabelaHash *t, size_t i);
+
+/* marcarFiltro() / passaNoFiltro() – liga os bits da chave no seu bloco / 0 se a chave
+   certamente não está no filtro. blocosDoFiltro() – blocos para uma tabela de 'capacidade'. */
+void marcarFiltro(FiltroBloom *f, unsigned long h);
+int passaNoFiltro(const FiltroBloom *f, unsigned long h);
+size_t blocosDoFiltro(size_t capacidade);
+
+#endif
@@ -0,0 +1,93 @@
+/* textos.c – textos internados: cada texto distinto vira um IdTexto de 32 bits */
+
+#include "textos.h"
+#include "hash.h"
+#include "associacoes.h"
+
+/* tabela global de textos (inicializada no primeiro uso) */
+TabelaTextos textosGlobais;
+
+/* internar: busca o texto no índice; se novo, copia para o armazenamento e emite o próximo id */
+IdTexto internar(const char *texto) {
+    if (!texto || texto[0] == '\0') return SEM_TEXTO;
+    TabelaTextos *tt = &textosGlobais;
+    if (!tt->indice.hashes) {
+        tt->indice.arena = NULL;
+        alocarSlots(&tt->indice, HASH_CAPACIDADE_INICIAL);
+        escolherKernelHash();
+        tt->total = 1; // id 0 reservado para SEM_TEXTO
+    }
+    unsigned long h = hashChave(texto);
+    long i = buscarSlot(&tt->indice, h, SEM_TEXTO, texto);
+    if (i >= 0) return tt->indice.entradas[i].pista;
+
+    if (tt->total >= tt->capTextos) {
+        uint32_t cap = tt->capTextos ? tt->capTextos * 2 : 64;
+        ESTAT_ALOCACAO(ALOC_TEXTOS, 1);
+        const char **v = (const char**) realloc((void*) tt->textos, cap * sizeof(char*));
+        if (!v) { perror("realloc"); exit(EXIT_FAILURE); }
+        v[0] = "";
+        tt->textos = v;
+        tt->capTextos = cap;
+    }
+    // o hash fica logo antes do texto: hashDoTexto() não precisa recalculá-lo
+    size_t L = strlen(texto) + 1;
+    unsigned long *bloco = (unsigned long*) arenaAlocar(&tt->armazenamento, sizeof(unsigned long) + L);
+    bloco[0] = h;
+    char *copia = (char*) (bloco + 1);
+    memcpy(copia, texto, L);
+    IdTexto id = tt->total++;
+    tt->textos[id] = copia;
+    HashEntry e = { id, SEM_TEXTO };
+    inserirSlot(&tt->indice, h, e);
+    return id;
+}
+
+IdTexto buscarTexto(const char *texto) {
+    if (!texto || texto[0] == '\0' || !textosGlobais.indice.hashes) return SEM_TEXTO;
+    long i = buscarSlot(&textosGlobais.indice, hashChave(texto), SEM_TEXTO, texto);
+    return i >= 0 ? textosGlobais.indice.entradas[i].pista : SEM_TEXTO;
+}
+
+const char* textoDe(IdTexto id) {
+    return id != SEM_TEXTO && id < textosGlobais.total ? textosGlobais.textos[id] : "";
+}
+
+/* hashDoTexto: hashChave de um texto internado (id válido), guardado por internar() */
+unsigned long hashDoTexto(IdTexto id) {
+    return ((const unsigned long*) textosGlobais.textos[id])[-1];
+}
+
+void liberarTextos(void) {
+    free((void*) textosGlobais.textos);
+    liberarHash(&textosGlobais.indice);
+    arenaLiberar(&textosGlobais.armazenamento);
+    memset(&textosGlobais, 0, sizeof(textosGlobais));
+    esquecerAssociacoesFixas();
+}
+
+/* aparar: remove espaços e quebra de linha das pontas (in place) */
+char* aparar(char *s) {
+    while (isspace((unsigned char) *s)) s++;
+    size_t L = strlen(s);
+    while (L > 0 && isspace((unsigned char) s[L-1])) s[--L] = '\0';
+    return s;
+}
+
+/* separarBarra: divide "a | b" em duas partes aparadas (b = NULL se não houver '|') */
+char* separarBarra(char *s, char **resto) {
+    char *barra = strchr(s, '|');
+    *resto = NULL;
+    if (barra) {
+        *barra = '\0';
+        *resto = aparar(barra + 1);
+    }
+    return aparar(s);
+}
+
+/* strip newline de fgets */
+void strip_newline(char *s) {
+    size_t L = strlen(s);
+    if (L == 0) return;
+    if (s[L-1] == '\n') s[L-1] = '\0';
+}
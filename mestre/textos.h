@@ -0,0 +1,42 @@
+/* textos.h – textos internados e utilitários de texto */
+#ifndef MESTRE_TEXTOS_H
+#define MESTRE_TEXTOS_H
+
+#include "tabela.h"
+
+/* Tabela global de textos internados: cada texto distinto recebe um id.
+   O índice texto -> id reaproveita a TabelaHash (o campo 'pista' guarda o id). */
+typedef struct TabelaTextos {
+    const char **textos;    // id -> texto; a posição 0 é SEM_TEXTO
+    uint32_t total;         // próximo id livre
+    uint32_t capTextos;
+    TabelaHash indice;
+    Arena armazenamento;    // bytes dos textos, com endereços estáveis
+} TabelaTextos;
+
+/* tabela global de textos (inicializada no primeiro uso) */
+extern TabelaTextos textosGlobais;
+
+/* internar() – devolve o id do texto, registrando-o se for novo ("" ou NULL -> SEM_TEXTO). */
+IdTexto internar(const char *texto);
+
+/* buscarTexto() – id de um texto já internado, sem registrar (SEM_TEXTO se desconhecido). */
+IdTexto buscarTexto(const char *texto);
+
+/* textoDe() – texto correspondente a um id ("" para SEM_TEXTO). */
+const char* textoDe(IdTexto id);
+
+/* liberarTextos() – descarta a tabela global de textos. */
+void liberarTextos(void);
+
+/* hashDoTexto() – hashChave de um texto internado (id válido), guardado por internar(). */
+unsigned long hashDoTexto(IdTexto id);
+
+/* aparar() – remove espaços e quebra de linha das pontas (in place).
+   separarBarra() – divide "a | b" em duas partes aparadas (b = NULL se não houver '|').
+   strip_newline() – remove o '\n' final deixado pelo fgets. */
+char* aparar(char *s);
+char* separarBarra(char *s, char **resto);
+void strip_newline(char *s);
+
+#endif
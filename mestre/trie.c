@@ -0,0 +1,172 @@
+/* trie.c – índice de prefixos das pistas (trie radix compacta sobre os textos internados) */
+
+#include "trie.h"
+#include "memoria.h"
+#include "textos.h"
+
+static NoTrie* novoNoTrie(const char *texto, uint32_t inicio, uint32_t fim) {
+    NoTrie *n = (NoTrie*) alocarNo(sizeof(NoTrie), ALOC_TRIE);
+    n->texto = texto;
+    n->inicio = inicio;
+    n->fim = fim;
+    n->pista = SEM_TEXTO;
+    n->ocorrencias = n->ocorrenciasSubarvore = 0;
+    n->distintasSubarvore = 0;
+    n->filho = n->irmao = NULL;
+    return n;
+}
+
+/* ligacaoDoFilho: endereço do ponteiro (filho ou irmão) onde está, ou entraria, o filho
+   cujo rótulo começa com o byte 'c' */
+static NoTrie** ligacaoDoFilho(NoTrie *n, unsigned char c) {
+    NoTrie **lig = &n->filho;
+    while (*lig && (unsigned char) (*lig)->texto[(*lig)->inicio] < c) lig = &(*lig)->irmao;
+    return lig;
+}
+
+/* somarNaTrie: desce consumindo rótulos; divide um nó quando o texto diverge no meio
+   do rótulo. A segunda descida (só para pistas novas) soma as distintas no caminho. */
+NoTrie* somarNaTrie(NoTrie *raiz, IdTexto pista, int vezes) {
+    if (pista == SEM_TEXTO) return raiz;
+    const char *texto = textoDe(pista);
+    uint32_t L = (uint32_t) strlen(texto), d = 0;
+    if (!raiz) raiz = novoNoTrie(texto, 0, 0);
+    NoTrie *n = raiz;
+    for (;;) {
+        n->ocorrenciasSubarvore += vezes;
+        if (d == L) break;
+        NoTrie **lig = ligacaoDoFilho(n, (unsigned char) texto[d]);
+        NoTrie *f = *lig;
+        if (!f || f->texto[f->inicio] != texto[d]) {
+            // nenhum filho começa com este byte: o resto do texto vira uma folha
+            NoTrie *folha = novoNoTrie(texto, d, L);
+            folha->irmao = f;
+            *lig = folha;
+            n = folha;
+            n->ocorrenciasSubarvore += vezes;
+            break;
+        }
+        uint32_t comum = 0, tamRotulo = f->fim - f->inicio;
+        while (comum < tamRotulo && d + comum < L && f->texto[f->inicio + comum] == texto[d + comum]) comum++;
+        if (comum < tamRotulo) {
+            // diverge no meio do rótulo: o trecho comum vira um nó intermediário
+            NoTrie *meio = novoNoTrie(f->texto, f->inicio, f->inicio + comum);
+            meio->irmao = f->irmao;
+            meio->filho = f;
+            meio->ocorrenciasSubarvore = f->ocorrenciasSubarvore;
+            meio->distintasSubarvore = f->distintasSubarvore;
+            f->inicio += comum;
+            f->irmao = NULL;
+            *lig = meio;
+            f = meio;
+        }
+        n = f;
+        d += comum;
+    }
+    n->ocorrencias += vezes;
+    if (n->pista != SEM_TEXTO) return raiz;
+
+    n->pista = pista;
+    for (NoTrie *c = raiz; ; ) {
+        c->distintasSubarvore++;
+        if (c == n) break;
+        c = *ligacaoDoFilho(c, (unsigned char) texto[c->fim]);
+    }
+    return raiz;
+}
+
+NoTrie* inserirNaTrie(NoTrie *raiz, IdTexto pista) {
+    return somarNaTrie(raiz, pista, 1);
+}
+
+/* descerPrefixo: nó cujo caminho contém o prefixo inteiro (pode terminar no meio do
+   rótulo); NULL se nenhuma pista começa com ele */
+static const NoTrie* descerPrefixo(const NoTrie *n, const char *prefixo) {
+    uint32_t L = (uint32_t) strlen(prefixo), d = 0;
+    while (n && d < L) {
+        const NoTrie *f = n->filho;
+        while (f && (unsigned char) f->texto[f->inicio] < (unsigned char) prefixo[d]) f = f->irmao;
+        if (!f || f->texto[f->inicio] != prefixo[d]) return NULL;
+        for (uint32_t i = f->inicio; i < f->fim && d < L; i++, d++)
+            if (f->texto[i] != prefixo[d]) return NULL;
+        n = f;
+    }
+    return n;
+}
+
+uint32_t contarPrefixo(const NoTrie *raiz, const char *prefixo, int *ocorrencias) {
+    const NoTrie *n = descerPrefixo(raiz, prefixo);
+    if (ocorrencias) *ocorrencias = n ? n->ocorrenciasSubarvore : 0;
+    return n ? n->distintasSubarvore : 0;
+}
+
+/* compararCaminho: caminho texto[0, L) contra um limite, como strcmp; 0 quando o
+   caminho é prefixo do limite (*igual diz se é o limite inteiro) */
+static int compararCaminho(const NoTrie *n, const char *limite, int *igual) {
+    int c = strncmp(n->texto, limite, n->fim);
+    *igual = c == 0 && limite[n->fim] == '\0';
+    return c;
+}
+
+/* percorrerTrie: pré-ordem com filhos em ordem de byte = ordem alfabética. Subárvores
+   abaixo de 'de' são puladas; ao passar de 'ate' o percurso termina (o resto é maior). */
+static size_t percorrerTrie(const NoTrie *inicio, const char *de, const char *ate, size_t limite,
+                            VisitanteTrie visitar, void *contexto) {
+    if (!inicio) return 0;
+    size_t visitadas = 0, topo = 0, cap = 64;
+    const NoTrie **pilha = (const NoTrie**) malloc(cap * sizeof(NoTrie*));
+    if (!pilha) { perror("malloc"); exit(EXIT_FAILURE); }
+    pilha[topo++] = inicio;
+    while (topo > 0) {
+        if (topo + 1 >= cap) {   // cada nó retirado empilha até dois (irmão e filho)
+            cap *= 2;
+            pilha = (const NoTrie**) realloc(pilha, cap * sizeof(NoTrie*));
+            if (!pilha) { perror("realloc"); exit(EXIT_FAILURE); }
+        }
+        const NoTrie *n = pilha[--topo];
+        int igual, visitarNo = n->pista != SEM_TEXTO;
+        if (n != inicio && n->irmao) pilha[topo++] = n->irmao;
+        if (de) {
+            int c = compararCaminho(n, de, &igual);
+            if (c < 0) continue;                       // tudo aqui é menor que 'de'
+            if (c == 0 && !igual) visitarNo = 0;       // prefixo próprio de 'de'
+        }
+        if (ate) {
+            int c = compararCaminho(n, ate, &igual);
+            if (c > 0 || igual) break;                 // daqui em diante tudo é >= 'ate'
+        }
+        if (visitarNo) {
+            visitadas++;
+            if (visitar(n->pista, n->ocorrencias, contexto) || visitadas == limite) break;
+        }
+        if (n->filho) pilha[topo++] = n->filho;
+    }
+    free(pilha);
+    return visitadas;
+}
+
+size_t visitarPrefixo(const NoTrie *raiz, const char *prefixo, size_t limite,
+                      VisitanteTrie visitar, void *contexto) {
+    return percorrerTrie(descerPrefixo(raiz, prefixo), NULL, NULL, limite, visitar, contexto);
+}
+
+size_t visitarIntervalo(const NoTrie *raiz, const char *de, const char *ate, size_t limite,
+                        VisitanteTrie visitar, void *contexto) {
+    return percorrerTrie(raiz, de, ate, limite, visitar, contexto);
+}
+
+/* liberarTrie: filho/irmão formam uma árvore binária; mesmas rotações de liberarSalas */
+void liberarTrie(NoTrie *raiz) {
+    while (raiz) {
+        if (raiz->filho) {
+            NoTrie *f = raiz->filho;
+            raiz->filho = f->irmao;
+            f->irmao = raiz;
+            raiz = f;
+        } else {
+            NoTrie *i = raiz->irmao;
+            free(raiz);
+            raiz = i;
+        }
+    }
+}
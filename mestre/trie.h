@@ -0,0 +1,44 @@
+/* trie.h – índice de prefixos das pistas */
+#ifndef MESTRE_TRIE_H
+#define MESTRE_TRIE_H
+
+#include "comum.h"
+
+/* Nó da trie radix de pistas. O rótulo não é copiado: é o trecho [inicio, fim) de um
+   texto internado que passa por este nó, então prefixos comuns ocupam um nó só e o
+   caminho da raiz até aqui é texto[0, fim). Filhos numa lista ordenada pelo primeiro
+   byte do rótulo (filho/irmão), o que dá a ordem alfabética no percurso. */
+typedef struct NoTrie {
+    const char *texto;
+    uint32_t inicio;
+    uint32_t fim;
+    IdTexto pista;              // pista que termina aqui (SEM_TEXTO se nenhuma)
+    int ocorrencias;            // dessa pista
+    int ocorrenciasSubarvore;   // soma de todas as pistas abaixo (inclusive esta)
+    uint32_t distintasSubarvore;
+    struct NoTrie *filho;
+    struct NoTrie *irmao;
+} NoTrie;
+
+/* Visitante da trie: devolve != 0 para interromper */
+typedef int (*VisitanteTrie)(IdTexto pista, int ocorrencias, void *contexto);
+
+/* inserirNaTrie() – soma uma ocorrência da pista ao índice de prefixos (cria a raiz se NULL). */
+NoTrie* inserirNaTrie(NoTrie *raiz, IdTexto pista);
+
+/* contarPrefixo() – pistas distintas e ocorrências que começam com 'prefixo', em O(k). */
+uint32_t contarPrefixo(const NoTrie *raiz, const char *prefixo, int *ocorrencias);
+
+/* visitarPrefixo() / visitarIntervalo() – visitam em ordem alfabética as pistas com o
+   prefixo, ou em [de, ate) (NULL = sem limite), parando após 'limite' resultados
+   (0 = sem limite) ou quando 'visitar' devolver != 0. Retornam quantas visitaram. */
+size_t visitarPrefixo(const NoTrie *raiz, const char *prefixo, size_t limite,
+                      VisitanteTrie visitar, void *contexto);
+size_t visitarIntervalo(const NoTrie *raiz, const char *de, const char *ate, size_t limite,
+                        VisitanteTrie visitar, void *contexto);
+void liberarTrie(NoTrie *raiz);
+
+/* somarNaTrie() – como inserirNaTrie, somando 'vezes' ocorrências de uma vez. */
+NoTrie* somarNaTrie(NoTrie *raiz, IdTexto pista, int vezes);
+
+#endif
@@ -0,0 +1,750 @@
+/*
+  Detective Quest - Testes do motor do Capítulo Final (mestre/)
+  Só asserções de comportamento; as medições de tempo ficam em benchmark_mestre.c.
+  - textos internados e tabela hash (substituição, ausentes, filtro de Bloom sem falso negativo)
+  - árvore de pistas: ordem, balanceamento, estatísticas de ordem, carga em lote e versões
+    persistentes contra uma referência ordenada com strcmp
+  - trie de prefixos contra a contagem direta
+  - sessão na mansão fixa: pistas, contadores x percurso da árvore, vereditos, ranking,
+    desfazer e bifurcar
+  - processo ponderado contra a soma direta dos pesos
+  - rotas numa mansão aleatória: ancestral comum, distância e rota contra a subida pelos pais
+  - mapa binário convertido de mapas/mansao_enigma.txt, em mmap e paginado com o cache
+    mínimo: as mesmas sessões da mansão fixa
+  - instantâneo: retomar reproduz a sessão gravada; arquivos truncados são recusados
+  - sessões em threads sobre a mesma mansão e tabela dão os vereditos da execução em série,
+    e a tabela concorrente não perde nem mistura associações com leitores ativos
+  Cada falha sai no stderr com a linha; o programa termina com EXIT_FAILURE se houver alguma.
+  (As recusas esperadas, de mapa inválido e instantâneo truncado, também deixam no stderr a
+  mensagem do próprio motor.)
+
+  Compilação: make testes_mestre
+  Uso:        make test   (ou ./testes_mestre, a partir da raiz do projeto)
+*/
+
+#include "mestre/associacoes.h"
+#include "mestre/concorrente.h"
+#include "mestre/exploracao.h"
+#include "mestre/hash.h"
+#include "mestre/instantaneo.h"
+#include "mestre/mapa.h"
+#include "mestre/paginada.h"
+#include "mestre/textos.h"
+
+#define MAPA_TEXTO "mapas/mansao_enigma.txt"
+#define TOTAL_TABELA 20000           // associações no teste da tabela hash
+#define TOTAL_DISTINTAS 1500         // pistas distintas no teste da árvore e da trie
+#define TOTAL_COLETAS 6000           // coletas (com repetições) no mesmo teste
+#define SALAS_ALEATORIAS 2000        // salas da mansão gerada para rotas e sessões em threads
+#define SESSOES_PARALELAS 600
+#define THREADS_TESTE 4
+
+static int falhas = 0;
+static unsigned long verificacoes = 0;
+
+#define CHECAR(cond) do {                                                           \
+        verificacoes++;                                                             \
+        if (!(cond)) {                                                              \
+            falhas++;                                                               \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);      \
+        }                                                                           \
+    } while (0)
+
+/* xorshift64: entradas determinísticas */
+static uint64_t estadoAleatorio = 0x9E3779B97F4A7C15ULL;
+static uint64_t aleatorio(void) {
+    estadoAleatorio ^= estadoAleatorio << 13;
+    estadoAleatorio ^= estadoAleatorio >> 7;
+    estadoAleatorio ^= estadoAleatorio << 17;
+    return estadoAleatorio;
+}
+
+static IdTexto internarNumero(const char *formato, unsigned n) {
+    char texto[64];
+    snprintf(texto, sizeof(texto), formato, n);
+    return internar(texto);
+}
+
+static int compararIds(const void *a, const void *b) {
+    return strcmp(textoDe(*(const IdTexto*) a), textoDe(*(const IdTexto*) b));
+}
+
+/* criarTemporario: caminho de um arquivo vazio em /tmp (o chamador o remove) */
+static void criarTemporario(char *caminho, size_t cap, const char *sufixo) {
+    snprintf(caminho, cap, "/tmp/testes_mestre_%s_XXXXXX", sufixo);
+    int fd = mkstemp(caminho);
+    if (fd < 0) { perror("mkstemp"); exit(EXIT_FAILURE); }
+    close(fd);
+}
+
+/* ------------------ Textos e tabela hash ------------------ */
+
+static void testarTextos(void) {
+    IdTexto a = internar("Pegada de lama");
+    CHECAR(a != SEM_TEXTO);
+    CHECAR(internar("Pegada de lama") == a);
+    CHECAR(buscarTexto("Pegada de lama") == a);
+    CHECAR(strcmp(textoDe(a), "Pegada de lama") == 0);
+    CHECAR(internar("") == SEM_TEXTO && internar(NULL) == SEM_TEXTO);
+    CHECAR(buscarTexto("texto nunca internado") == SEM_TEXTO);
+    CHECAR(strcmp(textoDe(SEM_TEXTO), "") == 0);
+
+    // textos de todos os tamanhos em volta dos blocos do hash vetorizado
+    char texto[3 * HASH_BLOCO + 2];
+    IdTexto ids[3 * HASH_BLOCO + 1];
+    for (size_t n = 1; n <= 3 * HASH_BLOCO; n++) {
+        for (size_t i = 0; i < n; i++) texto[i] = (char) ('a' + (i * 7 + n) % 26);
+        texto[n] = '\0';
+        ids[n] = internar(texto);
+        CHECAR(hashDoTexto(ids[n]) == hashChave(texto));
+    }
+    for (size_t n = 1; n <= 3 * HASH_BLOCO; n++) {
+        CHECAR(strlen(textoDe(ids[n])) == n);
+        CHECAR(buscarTexto(textoDe(ids[n])) == ids[n]);
+    }
+}
+
+static void testarTabelaHash(void) {
+    for (int comFiltro = 0; comFiltro <= 1; comFiltro++) {
+        TabelaHash t;
+        inicializarHash(&t);
+        if (comFiltro) ativarFiltro(&t);
+        // ids crus: a tabela por id não olha os textos
+        for (IdTexto p = 1; p <= TOTAL_TABELA; p++) inserirNaHashId(&t, p, 1000000 + p % 7);
+        CHECAR(t.tamanho == TOTAL_TABELA);
+        int erradas = 0, presentes = 0;
+        for (IdTexto p = 1; p <= TOTAL_TABELA; p++)
+            erradas += encontrarSuspeitoId(&t, p) != 1000000 + p % 7;
+        for (IdTexto p = TOTAL_TABELA + 1; p <= 2 * TOTAL_TABELA; p++)
+            presentes += encontrarSuspeitoId(&t, p) != SEM_TEXTO;
+        CHECAR(erradas == 0);
+        CHECAR(presentes == 0);
+
+        // substituir mantém o tamanho e vale na próxima consulta
+        for (IdTexto p = 1; p <= TOTAL_TABELA; p += 2) inserirNaHashId(&t, p, 2000000 + p);
+        CHECAR(t.tamanho == TOTAL_TABELA);
+        erradas = 0;
+        for (IdTexto p = 1; p <= TOTAL_TABELA; p++)
+            erradas += encontrarSuspeitoId(&t, p) != (p % 2 ? 2000000 + p : 1000000 + p % 7);
+        CHECAR(erradas == 0);
+        CHECAR(encontrarSuspeitoId(&t, SEM_TEXTO) == SEM_TEXTO);
+        liberarHash(&t);
+    }
+
+    TabelaHash t;
+    inicializarHash(&t);
+    inserirNaHash(&t, "Luvas sujas", "Sr. Rocha");
+    CHECAR(encontrarSuspeito(&t, "Luvas sujas") != NULL &&
+           strcmp(encontrarSuspeito(&t, "Luvas sujas"), "Sr. Rocha") == 0);
+    CHECAR(encontrarSuspeito(&t, "Pista que ninguém deixou") == NULL);
+    liberarHash(&t);
+}
+
+/* ------------------ Árvore de pistas e trie ------------------ */
+
+/* mesmasPistas: as duas árvores têm as mesmas pistas, na mesma ordem e com as mesmas contagens */
+static int mesmasPistas(const PistaNode *a, const PistaNode *b) {
+    IteradorPistas ia, ib;
+    iniciarIterador(&ia, a);
+    iniciarIterador(&ib, b);
+    for (;;) {
+        const PistaNode *x = proximaPista(&ia), *y = proximaPista(&ib);
+        if (!x || !y) return x == y;
+        if (x->pista != y->pista || x->ocorrencias != y->ocorrencias) return 0;
+    }
+}
+
+static void testarArvorePistas(void) {
+    static IdTexto distintas[TOTAL_DISTINTAS], ordenadas[TOTAL_DISTINTAS];
+    static IdTexto coletas[TOTAL_COLETAS];
+    static PistaContada lote[TOTAL_COLETAS];
+    static int ocorrencias[TOTAL_DISTINTAS];
+    for (unsigned i = 0; i < TOTAL_DISTINTAS; i++)
+        ordenadas[i] = distintas[i] = internarNumero("pista %05u", i * 37);
+    qsort(ordenadas, TOTAL_DISTINTAS, sizeof(IdTexto), compararIds);
+
+    PistaNode *raiz = NULL;
+    for (size_t i = 0; i < TOTAL_COLETAS; i++) {
+        // as primeiras coletas passam por todas as pistas; depois, repetições aleatórias
+        size_t d = i < TOTAL_DISTINTAS ? i : aleatorio() % TOTAL_DISTINTAS;
+        coletas[i] = distintas[d];
+        lote[i].pista = coletas[i];
+        lote[i].ocorrencias = 1;
+        raiz = inserirPista(raiz, coletas[i]);
+    }
+    for (size_t k = 0; k < TOTAL_DISTINTAS; k++) {
+        IdTexto *achada = (IdTexto*) bsearch(&distintas[k], ordenadas, TOTAL_DISTINTAS, sizeof(IdTexto),
+                                             compararIds);
+        ocorrencias[achada - ordenadas] = 0;
+    }
+    for (size_t i = 0; i < TOTAL_COLETAS; i++) {
+        IdTexto *achada = (IdTexto*) bsearch(&coletas[i], ordenadas, TOTAL_DISTINTAS, sizeof(IdTexto),
+                                             compararIds);
+        ocorrencias[achada - ordenadas]++;
+    }
+
+    // ordem alfabética, contagens e balanceamento (AVL: altura < 1,45 log2 n + 2)
+    IteradorPistas it;
+    iniciarIterador(&it, raiz);
+    size_t k = 0;
+    int foraDeOrdem = 0;
+    for (const PistaNode *n; (n = proximaPista(&it)) != NULL; k++)
+        foraDeOrdem += k >= TOTAL_DISTINTAS || n->pista != ordenadas[k] || n->ocorrencias != ocorrencias[k];
+    CHECAR(k == TOTAL_DISTINTAS);
+    CHECAR(foraDeOrdem == 0);
+    CHECAR(tamanhoPista(raiz) == TOTAL_DISTINTAS);
+    int log2 = 0;
+    while ((1u << (log2 + 1)) <= TOTAL_DISTINTAS) log2++;
+    CHECAR(alturaPista(raiz) <= log2 * 29 / 20 + 2);
+
+    // estatísticas de ordem contra a referência
+    int divergentes = 0;
+    for (k = 0; k < TOTAL_DISTINTAS; k++) {
+        const PistaNode *n = selecionarPista(raiz, k);
+        uint64_t antes;
+        divergentes += !n || n->pista != ordenadas[k];
+        divergentes += posicaoDaPista(raiz, textoDe(ordenadas[k]), &antes) != k;
+    }
+    CHECAR(divergentes == 0);
+    CHECAR(selecionarPista(raiz, TOTAL_DISTINTAS) == NULL);
+    for (int r = 0; r < 200; r++) {
+        size_t de = aleatorio() % TOTAL_DISTINTAS, ate = aleatorio() % TOTAL_DISTINTAS;
+        if (de > ate) { size_t x = de; de = ate; ate = x; }
+        uint64_t soma = 0, esperada = 0;
+        for (size_t i = de; i < ate; i++) esperada += (uint64_t) ocorrencias[i];
+        CHECAR(contarIntervaloPistas(raiz, textoDe(ordenadas[de]), textoDe(ordenadas[ate]), &soma) == ate - de);
+        CHECAR(soma == esperada);
+    }
+
+    // carga em lote e mescla dão a mesma árvore que as inserções
+    PistaNode *montada = montarPistas(lote, TOTAL_COLETAS);
+    CHECAR(mesmasPistas(montada, raiz));
+    CHECAR(tamanhoPista(montada) == TOTAL_DISTINTAS);
+    PistaNode *metade = montarPistas(lote, TOTAL_COLETAS / 2);
+    metade = mesclarPistas(metade, lote + TOTAL_COLETAS / 2, TOTAL_COLETAS - TOTAL_COLETAS / 2);
+    CHECAR(mesmasPistas(metade, raiz));
+
+    // versões persistentes: a anterior não muda com a inserção na nova
+    PistaNode *v1 = copiarPistasPersistente(raiz);
+    PistaNode *intermediaria = inserirPistaPersistente(v1, internar("pista nova da versão 2"));
+    PistaNode *v2 = inserirPistaPersistente(intermediaria, ordenadas[0]);
+    soltarPistas(intermediaria);
+    CHECAR(mesmasPistas(v1, raiz));
+    CHECAR(tamanhoPista(v2) == TOTAL_DISTINTAS + 1);
+    CHECAR(selecionarPista(v2, 0)->ocorrencias == ocorrencias[0] + 1);
+    soltarPistas(v1);
+    CHECAR(tamanhoPista(v2) == TOTAL_DISTINTAS + 1);
+    soltarPistas(v2);
+
+    // trie: contagens por prefixo contra a contagem direta, e a ordem da visita
+    NoTrie *trie = NULL;
+    for (size_t i = 0; i < TOTAL_COLETAS; i++) trie = inserirNaTrie(trie, coletas[i]);
+    const char *prefixos[] = { "", "pista", "pista 0", "pista 1", "pista 12", "pista 123", "pista 9999", "x" };
+    for (size_t p = 0; p < sizeof(prefixos) / sizeof(prefixos[0]); p++) {
+        size_t L = strlen(prefixos[p]);
+        uint32_t distintasEsperadas = 0;
+        int ocorrenciasEsperadas = 0, total = 0;
+        for (size_t i = 0; i < TOTAL_DISTINTAS; i++) {
+            if (strncmp(textoDe(ordenadas[i]), prefixos[p], L) != 0) continue;
+            distintasEsperadas++;
+            ocorrenciasEsperadas += ocorrencias[i];
+        }
+        CHECAR(contarPrefixo(trie, prefixos[p], &total) == distintasEsperadas);
+        CHECAR(total == ocorrenciasEsperadas);
+    }
+    liberarTrie(trie);
+    liberarPistas(raiz);
+    liberarPistas(montada);
+    liberarPistas(metade);
+}
+
+/* ------------------ Sessão na mansão fixa ------------------ */
+
+static const char *const SUSPEITOS_FIXOS[] = { "Sr. Verdes", "Sra. Marinho", "Sr. Rocha", "Pintor", "Motorista" };
+#define TOTAL_SUSPEITOS_FIXOS (sizeof(SUSPEITOS_FIXOS) / sizeof(SUSPEITOS_FIXOS[0]))
+
+/* jogar: sessão roteirizada e silenciosa (o chamador libera) */
+static void jogar(const Mansao *mansao, const TabelaHash *hash, const MapaRotas *rotas,
+                  const char *roteiro, Sessao *sessao) {
+    static Saida silenciosa = { NULL, 0, 0, 1 };
+    iniciarSessao(sessao);
+    sessao->roteiro = roteiro;
+    sessao->saida = &silenciosa;
+    sessao->rotas = rotas;
+    explorarSalas(mansao, sessao, hash);
+}
+
+static void testarSessaoFixa(void) {
+    TabelaHash hash;
+    inicializarHash(&hash);
+    Sala *raiz = montarMansaoFixa(&hash, NULL);
+    Mansao mansao = { raiz, NULL, NULL };
+    CHECAR(contarSalas(&mansao) == 8);
+    CHECAR(profundidadeMansao(&mansao) == 4);
+
+    // Hall, Sala de Estar, Biblioteca, Porão: uma pista para cada um de quatro suspeitos
+    Sessao s;
+    jogar(&mansao, &hash, NULL, "eees", &s);
+    CHECAR(tamanhoPista(s.raizPistas) == 4);
+    for (size_t i = 0; i < TOTAL_SUSPEITOS_FIXOS; i++)
+        CHECAR(verificarAcusacao(&s, SUSPEITOS_FIXOS[i]) ==
+               verificarSuspeitoFinal(s.raizPistas, &hash, SUSPEITOS_FIXOS[i]));
+    CHECAR(verificarAcusacao(&s, "Sr. Rocha") == 1);
+    CHECAR(verificarAcusacao(&s, "Motorista") == 0);
+    CHECAR(verificarAcusacao(&s, "Ninguém") == 0);
+    // empate: lidera quem chegou antes à contagem
+    CHECAR(suspeitoMaisProvavel(&s) == buscarTexto("Sr. Verdes"));
+    IdTexto ranking[TOTAL_SUSPEITOS_FIXOS];
+    CHECAR(suspeitosMaisProvaveis(&s, ranking, TOTAL_SUSPEITOS_FIXOS) == 4);
+    CHECAR(ranking[0] == buscarTexto("Sr. Verdes") && ranking[1] == buscarTexto("Sra. Marinho") &&
+           ranking[2] == buscarTexto("Sr. Rocha") && ranking[3] == buscarTexto("Pintor"));
+    CHECAR(julgarAcusacao(&s, "Sr. Rocha") == PROVAS_INSUFICIENTES);
+    CHECAR(julgarAcusacao(&s, "Motorista") == ACUSACAO_INFUNDADA);
+    liberarSessao(&s);
+
+    // com rotas, voltar ao Hall coleta de novo: Sra. Marinho (Lenço, Copo) e Sr. Verdes ficam com 2
+    MapaRotas rotas;
+    construirRotas(&mansao, &rotas);
+    jogar(&mansao, &hash, &rotas, "evds", &s);
+    CHECAR(verificarAcusacao(&s, "Sra. Marinho") == 2);
+    CHECAR(verificarAcusacao(&s, "Sr. Verdes") == 2);
+    CHECAR(julgarAcusacao(&s, "Sra. Marinho") == ACUSACAO_SUSTENTADA);
+    CHECAR(suspeitoMaisProvavel(&s) == buscarTexto("Sr. Verdes"));
+    liberarSessao(&s);
+
+    // histórico: desfazer reverte árvore e contadores; o ramo bifurcado é independente
+    IdTexto marinho = buscarTexto("Sra. Marinho");
+    iniciarSessao(&s);
+    ativarHistorico(&s);
+    coletarPista(&s, &hash, internar("Lenço rasgado"));
+    marcarPasso(&s);
+    coletarPista(&s, &hash, internar("Copo quebrado"));
+    CHECAR(evidenciasDe(&s, marinho) == 2);
+    CHECAR(desfazerPasso(&s) == 0);
+    CHECAR(evidenciasDe(&s, marinho) == 1);
+    CHECAR(tamanhoPista(s.raizPistas) == 1);
+    CHECAR(suspeitoMaisProvavel(&s) == marinho);
+    Sessao ramo;
+    bifurcarSessao(&s, &ramo);
+    coletarPista(&ramo, &hash, internar("Diário antigo"));
+    coletarPista(&ramo, &hash, internar("Luvas sujas"));
+    CHECAR(verificarAcusacao(&ramo, "Sr. Rocha") == 2);
+    CHECAR(verificarAcusacao(&s, "Sr. Rocha") == 0);
+    CHECAR(tamanhoPista(s.raizPistas) == 1 && tamanhoPista(ramo.raizPistas) == 3);
+    liberarSessao(&ramo);
+    liberarSessao(&s);
+
+    liberarRotas(&rotas);
+    liberarSalas(raiz);
+    liberarHash(&hash);
+}
+
+/* ------------------ Processo ponderado ------------------ */
+
+#define PISTAS_PROCESSO 300
+#define SUSPEITOS_PROCESSO 40
+
+static void testarProcesso(void) {
+    static uint32_t pesos[PISTAS_PROCESSO][SUSPEITOS_PROCESSO];
+    IdTexto pistas[PISTAS_PROCESSO], suspeitos[SUSPEITOS_PROCESSO];
+    for (unsigned i = 0; i < PISTAS_PROCESSO; i++) pistas[i] = internarNumero("indício %u", i);
+    for (unsigned i = 0; i < SUSPEITOS_PROCESSO; i++) suspeitos[i] = internarNumero("suspeito %u", i);
+
+    // a última implicação de um par vale; peso 0 desfaz o par
+    Processo processo;
+    iniciarProcesso(&processo);
+    for (int r = 0; r < 4000; r++) {
+        unsigned p = (unsigned) (aleatorio() % PISTAS_PROCESSO), s = (unsigned) (aleatorio() % SUSPEITOS_PROCESSO);
+        uint32_t peso = (uint32_t) (aleatorio() % 8 == 0 ? 0 : aleatorio() % (PESO_MAXIMO + 1));
+        pesos[p][s] = peso;
+        registrarImplicacao(&processo, pistas[p], suspeitos[s], peso);
+    }
+    compilarProcesso(&processo);
+
+    uint64_t *coletadas = (uint64_t*) calloc(processo.palavras ? processo.palavras : 1, sizeof(uint64_t));
+    PontuacaoSuspeito *saida = (PontuacaoSuspeito*) malloc((processo.totalSuspeitos + 1) * sizeof(PontuacaoSuspeito));
+    if (!coletadas || !saida) { perror("malloc"); exit(EXIT_FAILURE); }
+    int coletada[PISTAS_PROCESSO] = { 0 };
+    for (unsigned p = 0; p < PISTAS_PROCESSO; p++) {
+        uint32_t numero = numeroDaPista(&processo, pistas[p]);
+        if (numero == UINT32_MAX || aleatorio() % 3 == 0) continue;
+        coletada[p] = 1;
+        coletadas[numero / 64] |= 1ULL << (numero % 64);
+    }
+    pontuarSuspeitos(&processo, coletadas, saida);
+    int divergentes = 0;
+    for (uint32_t i = 0; i < processo.totalSuspeitos; i++) {
+        unsigned s = 0;
+        while (s < SUSPEITOS_PROCESSO && suspeitos[s] != saida[i].suspeito) s++;
+        if (s == SUSPEITOS_PROCESSO) { divergentes++; continue; }
+        uint32_t n = 0;
+        uint64_t soma = 0;
+        for (unsigned p = 0; p < PISTAS_PROCESSO; p++)
+            if (coletada[p] && pesos[p][s]) { n++; soma += pesos[p][s]; }
+        divergentes += saida[i].pistas != n || saida[i].peso != soma;
+    }
+    CHECAR(divergentes == 0);
+    free(coletadas);
+    free(saida);
+    liberarProcesso(&processo);
+}
+
+/* ------------------ Mansão aleatória: rotas e sessões em threads ------------------ */
+
+#define PISTAS_ALEATORIAS 300
+#define SUSPEITOS_ALEATORIOS 20
+
+/* gerarMansao: cada sala nova ocupa um caminho livre de uma sala já ligada; metade das
+   salas tem pista, e cada pista aponta para um suspeito */
+static Sala* gerarMansao(TabelaHash *hash) {
+    static Sala *salas[SALAS_ALEATORIAS];
+    char nome[32], pista[32];
+    for (unsigned i = 0; i < SALAS_ALEATORIAS; i++) {
+        snprintf(nome, sizeof(nome), "sala %u", i);
+        snprintf(pista, sizeof(pista), "vestígio %u", (unsigned) (aleatorio() % PISTAS_ALEATORIAS));
+        salas[i] = criarSala(nome, i % 2 ? pista : NULL);
+        while (i > 0) {
+            Sala *pai = salas[aleatorio() % i];
+            Sala **caminho = aleatorio() % 2 ? &pai->esquerda : &pai->direita;
+            if (!*caminho) { *caminho = salas[i]; break; }
+        }
+    }
+    for (unsigned p = 0; p < PISTAS_ALEATORIAS; p++)
+        inserirNaHashId(hash, internarNumero("vestígio %u", p),
+                        internarNumero("suspeito aleatório %u", (unsigned) (aleatorio() % SUSPEITOS_ALEATORIOS)));
+    return salas[0];
+}
+
+static void testarRotas(const Mansao *mansao) {
+    MapaRotas rotas;
+    construirRotas(mansao, &rotas);
+    CHECAR(rotas.total == SALAS_ALEATORIAS);
+    int divergentes = 0;
+    char passos[SALAS_ALEATORIAS + 1];
+    for (int r = 0; r < 3000; r++) {
+        uint32_t a = (uint32_t) (aleatorio() % rotas.total), b = (uint32_t) (aleatorio() % rotas.total);
+        // ancestral comum pela subida: o mais fundo sobe até as profundidades baterem
+        uint32_t x = a, y = b;
+        while (rotas.profundidade[x] > rotas.profundidade[y]) x = rotas.pai[x];
+        while (rotas.profundidade[y] > rotas.profundidade[x]) y = rotas.pai[y];
+        while (x != y) { x = rotas.pai[x]; y = rotas.pai[y]; }
+        uint32_t distancia = rotas.profundidade[a] + rotas.profundidade[b] - 2 * rotas.profundidade[x];
+        divergentes += ancestralComum(&rotas, a, b) != x;
+        divergentes += distanciaSalas(&rotas, a, b) != distancia;
+        divergentes += rotaEntreSalas(&rotas, a, b, passos, sizeof(passos)) != distancia;
+        divergentes += strlen(passos) != distancia;
+    }
+    CHECAR(divergentes == 0);
+    liberarRotas(&rotas);
+}
+
+/* Sessões roteirizadas e o que cada uma deve dar */
+typedef struct CasoParalelo {
+    char roteiro[24];
+    char acusado[32];
+    Veredito veredito;
+    int evidencias;
+    uint32_t pistas;
+} CasoParalelo;
+
+typedef struct TrabalhoParalelo {
+    const Mansao *mansao;
+    const TabelaHash *hash;
+    CasoParalelo *casos;
+    atomic_size_t proximo;
+    int divergentes[THREADS_TESTE];
+} TrabalhoParalelo;
+
+typedef struct TrabalhadorTeste {
+    TrabalhoParalelo *trabalho;
+    int indice;
+    pthread_t thread;
+} TrabalhadorTeste;
+
+/* rodarCaso: uma sessão numa arena; devolve o veredito e preenche evidências e pistas */
+static Veredito rodarCaso(const Mansao *mansao, const TabelaHash *hash, const CasoParalelo *caso,
+                          int *evidencias, uint32_t *pistas) {
+    Sessao s;
+    jogar(mansao, hash, NULL, caso->roteiro, &s);
+    Veredito v = julgarAcusacao(&s, caso->acusado);
+    *evidencias = verificarAcusacao(&s, caso->acusado);
+    *pistas = tamanhoPista(s.raizPistas);
+    liberarSessao(&s);
+    return v;
+}
+
+static void* trabalharParalelo(void *arg) {
+    TrabalhadorTeste *t = (TrabalhadorTeste*) arg;
+    TrabalhoParalelo *w = t->trabalho;
+    Arena arena = { NULL, NULL };
+    usarArena(&arena);
+    for (;;) {
+        size_t i = atomic_fetch_add(&w->proximo, 1);
+        if (i >= SESSOES_PARALELAS) break;
+        int evidencias;
+        uint32_t pistas;
+        Veredito v = rodarCaso(w->mansao, w->hash, &w->casos[i], &evidencias, &pistas);
+        w->divergentes[t->indice] += v != w->casos[i].veredito || evidencias != w->casos[i].evidencias ||
+                                     pistas != w->casos[i].pistas;
+        arenaResetar(&arena);
+    }
+    usarArena(NULL);
+    arenaLiberar(&arena);
+    return NULL;
+}
+
+static void testarSessoesParalelas(const Mansao *mansao, const TabelaHash *hash) {
+    static CasoParalelo casos[SESSOES_PARALELAS];
+    for (size_t i = 0; i < SESSOES_PARALELAS; i++) {
+        size_t n = 4 + aleatorio() % 16;
+        for (size_t j = 0; j < n; j++) casos[i].roteiro[j] = aleatorio() % 2 ? 'e' : 'd';
+        casos[i].roteiro[n] = 's';
+        casos[i].roteiro[n + 1] = '\0';
+        snprintf(casos[i].acusado, sizeof(casos[i].acusado), "suspeito aleatório %u",
+                 (unsigned) (aleatorio() % SUSPEITOS_ALEATORIOS));
+        casos[i].veredito = rodarCaso(mansao, hash, &casos[i], &casos[i].evidencias, &casos[i].pistas);
+    }
+    // a árvore coletada vale o percurso direto também numa sessão qualquer
+    Sessao s;
+    jogar(mansao, hash, NULL, casos[0].roteiro, &s);
+    CHECAR(verificarAcusacao(&s, casos[0].acusado) == verificarSuspeitoFinal(s.raizPistas, hash, casos[0].acusado));
+    liberarSessao(&s);
+
+    TrabalhoParalelo trabalho;
+    memset(&trabalho, 0, sizeof(trabalho));
+    trabalho.mansao = mansao;
+    trabalho.hash = hash;
+    trabalho.casos = casos;
+    atomic_init(&trabalho.proximo, 0);
+    TrabalhadorTeste trab[THREADS_TESTE];
+    for (int i = 0; i < THREADS_TESTE; i++) {
+        trab[i].trabalho = &trabalho;
+        trab[i].indice = i;
+        if (pthread_create(&trab[i].thread, NULL, trabalharParalelo, &trab[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int divergentes = 0;
+    for (int i = 0; i < THREADS_TESTE; i++) {
+        pthread_join(trab[i].thread, NULL);
+        divergentes += trabalho.divergentes[i];
+    }
+    CHECAR(divergentes == 0);
+}
+
+/* ------------------ Tabela concorrente ------------------ */
+
+#define CHAVES_CONCORRENTES 50000
+#define SUSPEITO_ANTIGO(p) (1000000 + (p))
+#define SUSPEITO_NOVO(p) (2000000 + (p))
+
+typedef struct LeituraConcorrente {
+    TabelaConcorrente *tc;
+    atomic_int *fim;
+    unsigned long invalidas, consultas;
+    pthread_t thread;
+} LeituraConcorrente;
+
+/* lerConcorrente: cada consulta vê nada, o suspeito antigo ou o novo, nunca outro par */
+static void* lerConcorrente(void *arg) {
+    LeituraConcorrente *l = (LeituraConcorrente*) arg;
+    uint64_t estado = 0x2545F4914F6CDD1DULL ^ (uint64_t) (uintptr_t) l;
+    while (!atomic_load(l->fim)) {
+        estado ^= estado << 13; estado ^= estado >> 7; estado ^= estado << 17;
+        IdTexto p = (IdTexto) (1 + estado % CHAVES_CONCORRENTES);
+        IdTexto s = buscarConcorrente(l->tc, p);
+        l->invalidas += s != SEM_TEXTO && s != SUSPEITO_ANTIGO(p) && s != SUSPEITO_NOVO(p);
+        l->consultas++;
+    }
+    liberarLeitorConcorrente();
+    return NULL;
+}
+
+static void testarTabelaConcorrente(void) {
+    TabelaConcorrente tc;
+    iniciarConcorrente(&tc);
+    atomic_int fim;
+    atomic_init(&fim, 0);
+    LeituraConcorrente leitores[THREADS_TESTE];
+    for (int i = 0; i < THREADS_TESTE; i++) {
+        leitores[i].tc = &tc;
+        leitores[i].fim = &fim;
+        leitores[i].invalidas = leitores[i].consultas = 0;
+        if (pthread_create(&leitores[i].thread, NULL, lerConcorrente, &leitores[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // a tabela cresce várias vezes com os leitores ativos; depois metade é substituída
+    for (IdTexto p = 1; p <= CHAVES_CONCORRENTES; p++) inserirConcorrente(&tc, p, SUSPEITO_ANTIGO(p));
+    for (IdTexto p = 1; p <= CHAVES_CONCORRENTES; p += 2) inserirConcorrente(&tc, p, SUSPEITO_NOVO(p));
+    atomic_store(&fim, 1);
+    unsigned long invalidas = 0;
+    for (int i = 0; i < THREADS_TESTE; i++) {
+        pthread_join(leitores[i].thread, NULL);
+        invalidas += leitores[i].invalidas;
+    }
+    CHECAR(invalidas == 0);
+    CHECAR(tc.tamanho == CHAVES_CONCORRENTES);
+    int erradas = 0;
+    for (IdTexto p = 1; p <= CHAVES_CONCORRENTES; p++)
+        erradas += buscarConcorrente(&tc, p) != (p % 2 ? SUSPEITO_NOVO(p) : SUSPEITO_ANTIGO(p));
+    CHECAR(erradas == 0);
+    CHECAR(buscarConcorrente(&tc, CHAVES_CONCORRENTES + 1) == SEM_TEXTO);
+
+    // com a tabela do jogo ligada a ela, as inserções seguintes vão para a concorrente
+    TabelaHash hash;
+    inicializarHash(&hash);
+    inserirNaHashId(&hash, CHAVES_CONCORRENTES + 1, SUSPEITO_ANTIGO(1));
+    tornarHashConcorrente(&hash, &tc);
+    CHECAR(encontrarSuspeitoId(&hash, CHAVES_CONCORRENTES + 1) == SUSPEITO_ANTIGO(1));
+    inserirNaHashId(&hash, CHAVES_CONCORRENTES + 2, SUSPEITO_NOVO(2));
+    CHECAR(buscarConcorrente(&tc, CHAVES_CONCORRENTES + 2) == SUSPEITO_NOVO(2));
+    liberarLeitorConcorrente();
+    liberarHash(&hash);
+    liberarConcorrente(&tc);
+}
+
+/* ------------------ Mapa binário e instantâneo ------------------ */
+
+static const char *const ROTEIROS_FIXOS[] = { "eees", "eds", "dds", "des", "ees", "s", "eedd" };
+#define TOTAL_ROTEIROS_FIXOS (sizeof(ROTEIROS_FIXOS) / sizeof(ROTEIROS_FIXOS[0]))
+
+/* mesmasSessoes: os roteiros fixos coletam as mesmas pistas e evidências nas duas mansões */
+static int mesmasSessoes(const Mansao *a, const TabelaHash *ha, const Mansao *b, const TabelaHash *hb) {
+    int divergentes = 0;
+    for (size_t r = 0; r < TOTAL_ROTEIROS_FIXOS; r++) {
+        Sessao sa, sb;
+        jogar(a, ha, NULL, ROTEIROS_FIXOS[r], &sa);
+        jogar(b, hb, NULL, ROTEIROS_FIXOS[r], &sb);
+        divergentes += !mesmasPistas(sa.raizPistas, sb.raizPistas);
+        for (size_t i = 0; i < TOTAL_SUSPEITOS_FIXOS; i++)
+            divergentes += verificarAcusacao(&sa, SUSPEITOS_FIXOS[i]) != verificarAcusacao(&sb, SUSPEITOS_FIXOS[i]);
+        divergentes += sa.maisProvavel != sb.maisProvavel;
+        liberarSessao(&sa);
+        liberarSessao(&sb);
+    }
+    return divergentes == 0;
+}
+
+static void testarMapaBinario(void) {
+    TabelaHash hashFixa;
+    inicializarHash(&hashFixa);
+    Sala *raiz = montarMansaoFixa(&hashFixa, NULL);
+    Mansao fixa = { raiz, NULL, NULL };
+
+    char caminho[64];
+    criarTemporario(caminho, sizeof(caminho), "mapa");
+    CHECAR(converterMapaTexto(MAPA_TEXTO, caminho) == 0);
+
+    MapaBinario mapa;
+    TabelaHash hashMapa;
+    inicializarHash(&hashMapa);
+    int carregado = carregarMapa(caminho, &mapa, &hashMapa, NULL) == 0;
+    CHECAR(carregado);
+    if (carregado) {
+        Mansao plana = { NULL, &mapa.mansao, NULL };
+        CHECAR(contarSalas(&plana) == contarSalas(&fixa));
+        CHECAR(profundidadeMansao(&plana) == profundidadeMansao(&fixa));
+        CHECAR(mesmasSessoes(&fixa, &hashFixa, &plana, &hashMapa));
+        fecharMapa(&mapa);
+    }
+    liberarHash(&hashMapa);
+
+    // paginada com o cache mínimo: salas entram e saem a cada passo
+    MansaoPaginada pg;
+    TabelaHash hashPaginada;
+    inicializarHash(&hashPaginada);
+    int aberta = abrirMansaoPaginada(caminho, CACHE_SALAS_MINIMO, &hashPaginada, NULL, &pg) == 0;
+    CHECAR(aberta);
+    if (aberta) {
+        Mansao paginada = { NULL, NULL, &pg };
+        CHECAR(contarSalas(&paginada) == contarSalas(&fixa));
+        CHECAR(mesmasSessoes(&fixa, &hashFixa, &paginada, &hashPaginada));
+        fecharMansaoPaginada(&pg);
+    }
+    liberarHash(&hashPaginada);
+    remove(caminho);
+
+    // arquivo que não é mapa
+    criarTemporario(caminho, sizeof(caminho), "lixo");
+    FILE *f = fopen(caminho, "w");
+    if (f) { fputs("não é um mapa", f); fclose(f); }
+    TabelaHash hashLixo;
+    inicializarHash(&hashLixo);
+    CHECAR(carregarMapa(caminho, &mapa, &hashLixo, NULL) != 0);
+    liberarHash(&hashLixo);
+    remove(caminho);
+
+    liberarSalas(raiz);
+    liberarHash(&hashFixa);
+}
+
+static void testarInstantaneo(void) {
+    TabelaHash hash;
+    inicializarHash(&hash);
+    Sala *raiz = montarMansaoFixa(&hash, NULL);
+    Mansao mansao = { raiz, NULL, NULL };
+    char caminho[64];
+    criarTemporario(caminho, sizeof(caminho), "sessao");
+
+    Sessao s, r;
+    jogar(&mansao, &hash, NULL, "ee", &s);   // para na Biblioteca (o roteiro acaba em 's')
+    CHECAR(salvarSessao(caminho, &mansao, &s) == 0);
+    iniciarSessao(&r);
+    CHECAR(retomarSessao(caminho, &mansao, &r) == 0);
+    CHECAR(mesmasPistas(s.raizPistas, r.raizPistas));
+    for (size_t i = 0; i < TOTAL_SUSPEITOS_FIXOS; i++)
+        CHECAR(verificarAcusacao(&s, SUSPEITOS_FIXOS[i]) == verificarAcusacao(&r, SUSPEITOS_FIXOS[i]));
+    CHECAR(suspeitoMaisProvavel(&s) == suspeitoMaisProvavel(&r));
+    CHECAR(posicaoValida(&mansao, r.atual) && r.atual.sala == s.atual.sala);
+
+    // continuar a retomada coleta só o que vem depois da sala salva
+    static Saida silenciosa = { NULL, 0, 0, 1 };
+    r.roteiro = "es";
+    r.saida = &silenciosa;
+    explorarSalas(&mansao, &r, &hash);
+    CHECAR(tamanhoPista(r.raizPistas) == tamanhoPista(s.raizPistas) + 1);
+    CHECAR(verificarAcusacao(&r, "Pintor") == 1);
+    liberarSessao(&r);
+    liberarSessao(&s);
+
+    // truncado: recusado, e a sessão continua vazia
+    if (truncate(caminho, sizeof(CabecalhoSessao) + 2) != 0) perror("truncate");
+    iniciarSessao(&r);
+    CHECAR(retomarSessao(caminho, &mansao, &r) != 0);
+    CHECAR(r.raizPistas == NULL);
+    liberarSessao(&r);
+    remove(caminho);
+
+    liberarSalas(raiz);
+    liberarHash(&hash);
+}
+
+/* ------------------ Programa principal ------------------ */
+
+int main(void) {
+    testarTextos();
+    testarTabelaHash();
+    testarArvorePistas();
+    testarSessaoFixa();
+    testarProcesso();
+
+    TabelaHash hash;
+    inicializarHash(&hash);
+    Sala *raiz = gerarMansao(&hash);
+    Mansao mansao = { raiz, NULL, NULL };
+    testarRotas(&mansao);
+    testarSessoesParalelas(&mansao, &hash);
+    liberarSalas(raiz);
+    liberarHash(&hash);
+
+    testarTabelaConcorrente();
+    testarMapaBinario();
+    testarInstantaneo();
+    liberarTextos();
+
+    printf("%lu verificações, %d falha(s)\n", verificacoes, falhas);
+    return falhas ? EXIT_FAILURE : EXIT_SUCCESS;
+}